@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <stdexcept>
+#include "batch-powmod.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BATCH_POWMOD_X86 1
+#endif
+
+namespace {
+
+const uint64_t DIGIT_MASK = 0xFFFFFFFFULL; // radix 2^32 digits, one per 64-bit lane slot
+const unsigned int WINDOW_BITS = 4;
+const size_t WINDOW_SIZE = size_t(1) << WINDOW_BITS;
+const size_t L = POWMOD_LANES;
+
+/**
+ * Lane-interleaved operands: digit j of lane l lives at [j * L + l], so one 256-bit load picks
+ * up the same digit of all four lanes. `t` is scratch space of (n + 2) * L words.
+ */
+typedef void (*MontMulKernel)(uint64_t* out, const uint64_t* a, const uint64_t* b, const uint64_t* m,
+                              const uint64_t* m_prime, size_t n, uint64_t* t);
+
+/**
+ * @brief Per-lane CIOS Montgomery product out = a * b / 2^(32n) mod m, one lane at a time.
+ *
+ * Every step stays inside 64 bits: t_j + a_j * b_i + carry <= 2^64 - 1 for 32-bit digits.
+ * `out` may alias `a` or `b`; it is only written once the product is complete.
+ */
+void mont_mul_scalar(uint64_t* out, const uint64_t* a, const uint64_t* b, const uint64_t* m,
+                     const uint64_t* m_prime, size_t n, uint64_t* t) {
+    for (size_t l = 0; l < L; ++l) {
+        for (size_t j = 0; j < n + 2; ++j) {
+            t[j * L + l] = 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t b_i = b[i * L + l];
+            uint64_t carry = 0;
+            for (size_t j = 0; j < n; ++j) {
+                uint64_t s = t[j * L + l] + a[j * L + l] * b_i + carry;
+                t[j * L + l] = s & DIGIT_MASK;
+                carry = s >> 32;
+            }
+            uint64_t s = t[n * L + l] + carry;
+            t[n * L + l] = s & DIGIT_MASK;
+            t[(n + 1) * L + l] = s >> 32;
+
+            uint64_t u = (t[l] * m_prime[l]) & DIGIT_MASK;
+            carry = (t[l] + u * m[l]) >> 32;
+            for (size_t j = 1; j < n; ++j) {
+                s = t[j * L + l] + u * m[j * L + l] + carry;
+                t[(j - 1) * L + l] = s & DIGIT_MASK;
+                carry = s >> 32;
+            }
+            s = t[n * L + l] + carry;
+            t[(n - 1) * L + l] = s & DIGIT_MASK;
+            t[n * L + l] = t[(n + 1) * L + l] + (s >> 32);
+        }
+
+        // t < 2m: subtract m unless that borrows out of the top digit.
+        uint64_t borrow = 0;
+        for (size_t j = 0; j < n; ++j) {
+            uint64_t d = t[j * L + l] - m[j * L + l] - borrow;
+            out[j * L + l] = d & DIGIT_MASK;
+            borrow = d >> 63;
+        }
+        if (t[n * L + l] != borrow) {
+            for (size_t j = 0; j < n; ++j) {
+                out[j * L + l] = t[j * L + l];
+            }
+        }
+    }
+}
+
+#ifdef BATCH_POWMOD_X86
+/**
+ * @brief The scalar kernel with the lane loop moved into AVX2 registers: _mm256_mul_epu32
+ *        forms the four 32x32->64 digit products of one CIOS step at once.
+ */
+__attribute__((target("avx2")))
+void mont_mul_avx2(uint64_t* out, const uint64_t* a, const uint64_t* b, const uint64_t* m,
+                   const uint64_t* m_prime, size_t n, uint64_t* t) {
+#define LOAD(p) _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))
+#define STORE(p, v) _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v)
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(DIGIT_MASK));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mp = LOAD(m_prime);
+
+    for (size_t j = 0; j < n + 2; ++j) {
+        STORE(t + j * L, zero);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        __m256i b_i = LOAD(b + i * L);
+        __m256i carry = zero;
+        for (size_t j = 0; j < n; ++j) {
+            __m256i s = _mm256_add_epi64(LOAD(t + j * L), _mm256_add_epi64(_mm256_mul_epu32(LOAD(a + j * L), b_i), carry));
+            STORE(t + j * L, _mm256_and_si256(s, mask));
+            carry = _mm256_srli_epi64(s, 32);
+        }
+        __m256i s = _mm256_add_epi64(LOAD(t + n * L), carry);
+        STORE(t + n * L, _mm256_and_si256(s, mask));
+        STORE(t + (n + 1) * L, _mm256_srli_epi64(s, 32));
+
+        __m256i t_0 = LOAD(t);
+        __m256i u = _mm256_and_si256(_mm256_mul_epu32(t_0, mp), mask);
+        carry = _mm256_srli_epi64(_mm256_add_epi64(t_0, _mm256_mul_epu32(u, LOAD(m))), 32);
+        for (size_t j = 1; j < n; ++j) {
+            s = _mm256_add_epi64(LOAD(t + j * L), _mm256_add_epi64(_mm256_mul_epu32(u, LOAD(m + j * L)), carry));
+            STORE(t + (j - 1) * L, _mm256_and_si256(s, mask));
+            carry = _mm256_srli_epi64(s, 32);
+        }
+        s = _mm256_add_epi64(LOAD(t + n * L), carry);
+        STORE(t + (n - 1) * L, _mm256_and_si256(s, mask));
+        STORE(t + n * L, _mm256_add_epi64(LOAD(t + (n + 1) * L), _mm256_srli_epi64(s, 32)));
+    }
+
+    __m256i borrow = zero;
+    for (size_t j = 0; j < n; ++j) {
+        __m256i d = _mm256_sub_epi64(_mm256_sub_epi64(LOAD(t + j * L), LOAD(m + j * L)), borrow);
+        STORE(out + j * L, _mm256_and_si256(d, mask));
+        borrow = _mm256_srli_epi64(d, 63);
+    }
+    __m256i use_difference = _mm256_cmpeq_epi64(LOAD(t + n * L), borrow);
+    for (size_t j = 0; j < n; ++j) {
+        STORE(out + j * L, _mm256_blendv_epi8(LOAD(t + j * L), LOAD(out + j * L), use_difference));
+    }
+#undef LOAD
+#undef STORE
+}
+#endif
+
+MontMulKernel select_kernel(PowmodKernel kernel) {
+    switch (kernel) {
+    case POWMOD_KERNEL_SCALAR:
+        return mont_mul_scalar;
+    case POWMOD_KERNEL_AVX2:
+        if (!powmod_avx2_available()) {
+            throw std::runtime_error("AVX2 powmod kernel is not supported on this CPU.");
+        }
+        break;
+    case POWMOD_KERNEL_AUTO:
+        if (!powmod_avx2_available()) return mont_mul_scalar;
+        break;
+    }
+#ifdef BATCH_POWMOD_X86
+    return mont_mul_avx2;
+#else
+    return mont_mul_scalar;
+#endif
+}
+
+void load_digits(const BigInt& value, size_t n, size_t lane, uint64_t* dst) {
+    const uint64_t* limbs = value.limb_data();
+    size_t count = value.limb_count();
+    for (size_t j = 0; j < n; ++j) {
+        uint64_t word = j / 2 < count ? limbs[j / 2] : 0;
+        dst[j * L + lane] = j % 2 == 0 ? word & DIGIT_MASK : word >> 32;
+    }
+}
+
+BigInt store_digits(const uint64_t* src, size_t n, size_t lane) {
+    std::vector<uint64_t> words((n + 1) / 2, 0);
+    for (size_t j = 0; j < n; ++j) {
+        words[j / 2] |= src[j * L + lane] << (32 * (j % 2));
+    }
+    BigInt value(uint64_t(0));
+    value.assign_limbs(words.data(), words.size());
+    return value;
+}
+
+/**
+ * @brief -m^-1 mod 2^32 by Newton iteration; each step doubles the number of correct bits.
+ */
+uint64_t montgomery_inverse(uint64_t m_0) {
+    uint32_t m = static_cast<uint32_t>(m_0);
+    uint32_t inverse = m; // correct to 3 bits for odd m
+    for (int i = 0; i < 4; ++i) {
+        inverse *= 2 - m * inverse;
+    }
+    return static_cast<uint32_t>(0 - inverse);
+}
+
+/**
+ * @brief Runs up to POWMOD_LANES exponentiations in lockstep with a fixed 4-bit window.
+ *
+ * Unused lanes repeat lane 0. All lanes share the digit count of the widest modulus and the
+ * window count of the longest exponent; windows that are zero in every lane skip the multiply.
+ */
+void powmod_group(const BigInt* bases, const BigInt* exponents, const BigInt* moduli, size_t count,
+                  BigInt* results, MontMulKernel mont_mul) {
+    size_t n = 1;
+    size_t exponent_bits = 0;
+    for (size_t l = 0; l < count; ++l) {
+        n = std::max(n, (moduli[l].bit_length() + 31) / 32);
+        exponent_bits = std::max(exponent_bits, exponents[l].bit_length());
+    }
+
+    std::vector<uint64_t> m(n * L), m_prime(L), t((n + 2) * L), acc(n * L), operand(n * L), plain_one(n * L, 0);
+    std::vector<std::vector<uint64_t>> table(WINDOW_SIZE, std::vector<uint64_t>(n * L));
+    for (size_t l = 0; l < L; ++l) {
+        size_t src = l < count ? l : 0;
+        const BigInt& modulus = moduli[src];
+        BigInt r(uint64_t(1));
+        r <<= 32 * n;
+        BigInt base = bases[src] % modulus;
+        base <<= 32 * n;
+        load_digits(modulus, n, l, m.data());
+        m_prime[l] = montgomery_inverse(m[l]);
+        load_digits(r % modulus, n, l, table[0].data());
+        load_digits(base % modulus, n, l, table[1].data());
+        plain_one[l] = 1;
+    }
+    for (size_t w = 2; w < WINDOW_SIZE; ++w) {
+        mont_mul(table[w].data(), table[w - 1].data(), table[1].data(), m.data(), m_prime.data(), n, t.data());
+    }
+
+    acc = table[0];
+    size_t windows = (exponent_bits + WINDOW_BITS - 1) / WINDOW_BITS;
+    for (size_t w = windows; w-- > 0;) {
+        if (w + 1 != windows) {
+            for (unsigned int k = 0; k < WINDOW_BITS; ++k) {
+                mont_mul(acc.data(), acc.data(), acc.data(), m.data(), m_prime.data(), n, t.data());
+            }
+        }
+        bool any = false;
+        for (size_t l = 0; l < L; ++l) {
+            const BigInt& exponent = exponents[l < count ? l : 0];
+            size_t digit = 0;
+            for (unsigned int k = WINDOW_BITS; k-- > 0;) {
+                digit = (digit << 1) | (exponent.get_bit(w * WINDOW_BITS + k) ? 1 : 0);
+            }
+            any = any || digit != 0;
+            for (size_t j = 0; j < n; ++j) {
+                operand[j * L + l] = table[digit][j * L + l];
+            }
+        }
+        if (any) {
+            mont_mul(acc.data(), acc.data(), operand.data(), m.data(), m_prime.data(), n, t.data());
+        }
+    }
+
+    mont_mul(acc.data(), acc.data(), plain_one.data(), m.data(), m_prime.data(), n, t.data());
+    for (size_t l = 0; l < count; ++l) {
+        results[l] = store_digits(acc.data(), n, l);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Reports whether the CPU (per CPUID, via __builtin_cpu_supports) can run the AVX2 kernel.
+ */
+bool powmod_avx2_available() {
+#ifdef BATCH_POWMOD_X86
+    static const bool available = __builtin_cpu_supports("avx2");
+    return available;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Name of the kernel a request resolves to on this CPU.
+ */
+const char* powmod_kernel_name(PowmodKernel kernel) {
+    return select_kernel(kernel) == mont_mul_scalar ? "scalar" : "avx2";
+}
+
+/**
+ * @brief Computes bases[i]^exponents[i] mod moduli[i] for every i, POWMOD_LANES at a time.
+ *
+ * Each group of lanes runs one Montgomery exponentiation per lane in lockstep, so the batch
+ * pays off when the moduli have similar sizes (as in a prime search or a batch of tests).
+ *
+ * @param bases Bases, reduced modulo their modulus.
+ * @param exponents Non-negative exponents.
+ * @param moduli Odd moduli.
+ * @param kernel Kernel to use; POWMOD_KERNEL_AUTO picks AVX2 when available.
+ * @return The results, in input order.
+ */
+std::vector<BigInt> batch_modular_pow(const std::vector<BigInt>& bases,
+                                      const std::vector<BigInt>& exponents,
+                                      const std::vector<BigInt>& moduli,
+                                      PowmodKernel kernel) {
+    if (bases.size() != moduli.size() || exponents.size() != moduli.size()) {
+        throw std::invalid_argument("Batch modular_pow needs one base and exponent per modulus.");
+    }
+    for (const auto& modulus : moduli) {
+        if (modulus.is_even()) {
+            throw std::invalid_argument("Batch modular_pow needs odd moduli.");
+        }
+    }
+    MontMulKernel mont_mul = select_kernel(kernel);
+
+    std::vector<BigInt> results(moduli.size(), BigInt(uint64_t(0)));
+    for (size_t i = 0; i < moduli.size(); i += L) {
+        size_t count = std::min(L, moduli.size() - i);
+        powmod_group(&bases[i], &exponents[i], &moduli[i], count, &results[i], mont_mul);
+    }
+    return results;
+}
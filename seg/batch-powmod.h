@@ -0,0 +1,26 @@
+#ifndef BATCH_POWMOD_H
+#define BATCH_POWMOD_H
+
+#include <vector>
+#include "bigint.h"
+
+/**
+ * @brief Montgomery multiplication kernels available to batch_modular_pow.
+ */
+enum PowmodKernel {
+    POWMOD_KERNEL_AUTO,   // AVX2 when CPUID reports it, scalar otherwise
+    POWMOD_KERNEL_SCALAR,
+    POWMOD_KERNEL_AVX2
+};
+
+const size_t POWMOD_LANES = 4; // exponentiations run in lockstep per kernel call
+
+bool powmod_avx2_available();
+const char* powmod_kernel_name(PowmodKernel kernel);
+
+std::vector<BigInt> batch_modular_pow(const std::vector<BigInt>& bases,
+                                      const std::vector<BigInt>& exponents,
+                                      const std::vector<BigInt>& moduli,
+                                      PowmodKernel kernel = POWMOD_KERNEL_AUTO);
+
+#endif // BATCH_POWMOD_H
@@ -4,11 +4,22 @@
 #include <iomanip>
 #include <functional>
 #include <cassert>
+#include <thread>
+#include <algorithm>
+#include <iterator>
+#include <ctime>
 
 #include "bigint.h"
 #include "xorshift.h"
 #include "fermat.h"
 #include "miller-rabin.h"
+#include "cmwc.h"
+#include "random_pool.h"
+#include "shawe-taylor.h"
+#include "safe-prime.h"
+#include "batch-powmod.h"
+#include "multi-exp.h"
+#include "prime-sieve.h"
 
 /**
  * @brief Finds the next prime number starting from a given number.
@@ -16,19 +27,50 @@
  * @param n The starting number.
  * @param k The number of rounds for the primality test.
  * @param prime_test A function pointer to the primality test to use.
+ * @param base2_screen Run is_sprp_base2 as the first round, so prime_test only sees candidates
+ *        that survive it.
  * @return The first prime number found at or after n.
  */
-BigInt find_next_prime(BigInt n, int k, const std::function<bool(const BigInt&, int)>& prime_test) {
+BigInt find_next_prime(BigInt n, int k, const std::function<bool(const BigInt&, int)>& prime_test,
+                       bool base2_screen = true) {
     if (n.is_even() && n != BigInt(uint64_t(2))) {
         n = n + BigInt(uint64_t(1));
     }
-    while (!prime_test(n, k)) {
+    while ((base2_screen && !is_sprp_base2(n)) || !prime_test(n, k)) {
         n = n + BigInt(uint64_t(2));
-        std::cout << "n: " << n.to_hex_string() << std::endl;
     }
     return n;
 }
 
+/**
+ * @brief Checks that a one-slot ring buffer (and a RandomPool of depth 1) still works: the
+ *        capacity is raised to 2, so a second push into a full buffer fails instead of
+ *        overwriting the queued value.
+ */
+void test_ring_buffer() {
+    std::cout << "Testing ring buffer..." << std::endl;
+    RingBuffer<BigInt> one(1);
+    assert(one.capacity() == 2);
+    BigInt first(uint64_t(1)), second(uint64_t(2)), third(uint64_t(3));
+    assert(one.try_push(first));
+    assert(one.try_push(second));
+    assert(!one.try_push(third));
+    BigInt value(uint64_t(0));
+    assert(one.try_pop(value) && value == BigInt(uint64_t(1)));
+    assert(one.try_pop(value) && value == BigInt(uint64_t(2)));
+    assert(!one.try_pop(value));
+
+    auto factory = [](unsigned int) {
+        return RandomPool::Generator([]() { return BigInt(uint64_t(7)); });
+    };
+    RandomPool pool(64, factory, 1, 1);
+    assert(pool.depth() == 2);
+    for (int i = 0; i < 16; ++i) {
+        assert(pool.next() == BigInt(uint64_t(7)));
+    }
+    std::cout << "Ring buffer tests passed." << std::endl;
+}
+
 /**
  * @brief Tests the Fermat and Miller-Rabin primality testers with known 40-bit primes and composites.
  */
@@ -37,17 +79,17 @@ void test_primality_testers() {
     std::cout << "| Running primality tester validation                                                      |" << std::endl;
     std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
 
-    BigInt two_pow_40(1ULL);
+    BigInt two_pow_40(uint64_t(1));
     two_pow_40 <<= 40;
 
     std::vector<BigInt> primes = {
-        two_pow_40 - BigInt(87ULL),
-        two_pow_40 - BigInt(207ULL)
+        two_pow_40 - BigInt(uint64_t(87)),
+        two_pow_40 - BigInt(uint64_t(167))
     };
 
     std::vector<BigInt> composites = {
-        two_pow_40 - BigInt(1ULL),
-        two_pow_40 - BigInt(2ULL)
+        two_pow_40 - BigInt(uint64_t(1)),
+        two_pow_40 - BigInt(uint64_t(2))
     };
 
     int k = 10; // Number of rounds for primality tests
@@ -56,6 +98,7 @@ void test_primality_testers() {
         std::cout << "Testing prime: " << p.to_hex_string() << std::endl;
         assert(is_prime_fermat(p, k));
         assert(is_prime_miller_rabin(p, k));
+        assert(is_sprp_base2(p));
         std::cout << "  - PASSED" << std::endl;
     }
 
@@ -63,26 +106,604 @@ void test_primality_testers() {
         std::cout << "Testing composite: " << c.to_hex_string() << std::endl;
         assert(!is_prime_fermat(c, k));
         assert(!is_prime_miller_rabin(c, k));
+        assert(!is_sprp_base2(c));
         std::cout << "  - PASSED" << std::endl;
     }
+
+    // Strong pseudoprimes to base 2 pass the screen; the full test behind it still rejects them.
+    for (uint64_t pseudoprime : {2047ULL, 3277ULL, 4033ULL, 4681ULL, 8321ULL}) {
+        BigInt c(pseudoprime);
+        assert(is_sprp_base2(c));
+        assert(!is_prime_miller_rabin(c, k));
+        assert(find_next_prime(c, k, is_prime_miller_rabin) != c);
+    }
+    for (uint64_t value = 1; value < 3000; ++value) {
+        BigInt n(value);
+        bool prime = value >= 2;
+        for (uint64_t f = 2; f * f <= value; ++f) {
+            if (value % f == 0) prime = false;
+        }
+        assert(is_sprp_base2(n) == (prime || value == 2047));
+    }
     std::cout << "All primality tests passed!" << std::endl;
 }
 
+/**
+ * @brief Checks that the batch Fermat and Miller-Rabin paths agree with the scalar testers.
+ */
+void test_batch_primality_testers() {
+    std::cout << "Running batch primality tester validation (" << powmod_kernel_name(POWMOD_KERNEL_AUTO) << " kernel)..." << std::endl;
+    BigInt two_pow_40(uint64_t(1));
+    two_pow_40 <<= 40;
+
+    std::vector<BigInt> candidates = {
+        BigInt(uint64_t(2)), BigInt(uint64_t(3)), BigInt(uint64_t(4)), BigInt(uint64_t(9)),
+        two_pow_40 - BigInt(uint64_t(87)), two_pow_40 - BigInt(uint64_t(1)),
+        two_pow_40 - BigInt(uint64_t(167)), two_pow_40 - BigInt(uint64_t(2)),
+        BigInt(uint64_t(1000003)), BigInt(uint64_t(1000001))
+    };
+    std::vector<bool> expected = {true, true, false, false, true, false, true, false, true, false};
+
+    int k = 10;
+    std::vector<bool> fermat = is_prime_fermat_batch(candidates, k);
+    std::vector<bool> miller_rabin = is_prime_miller_rabin_batch(candidates, k);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        assert(fermat[i] == expected[i]);
+        assert(miller_rabin[i] == expected[i]);
+    }
+    std::cout << "Batch primality tests passed!" << std::endl;
+}
+
+/**
+ * @brief Checks the segmented sieve against known prime counts, against itself across thread
+ *        counts, and against Miller-Rabin on every odd number of sampled windows.
+ */
+void test_segmented_sieve() {
+    std::cout << "Running segmented sieve validation..." << std::endl;
+    assert(count_primes(0, 2) == 0);
+    assert(count_primes(2, 3) == 1);
+    assert(count_primes(0, 30) == 10);
+    assert(count_primes(0, 1000000) == 78498);
+    assert(count_primes(0, 100000000, 4) == 5761455);
+
+    std::vector<uint64_t> small;
+    copy_primes(0, 100, std::back_inserter(small), 3);
+    assert(small.size() == 25 && small.front() == 2 && small.back() == 97);
+
+    // 2^56 needs sieving primes past the stored ones, which are regenerated per run.
+    const uint64_t starts[] = {1000000000000ULL, 1000000000000ULL + 9999000000ULL, 1000000000000000ULL,
+                               1ULL << 56};
+    CMWC rng(time(0));
+    for (uint64_t start : starts) {
+        for (int window = 0; window < 3; ++window) {
+            uint64_t low = start + rng.next() % 1000000;
+            uint64_t high = low + 3000;
+            std::vector<uint64_t> primes;
+            for_each_prime(low, high, [&primes](uint64_t p) { primes.push_back(p); }, 2);
+            assert(primes.size() == count_primes(low, high, 3));
+
+            size_t next = 0;
+            for (uint64_t n = low | 1; n < high; n += 2) {
+                bool prime = is_prime_miller_rabin(BigInt(n), 10);
+                bool listed = next < primes.size() && primes[next] == n;
+                assert(prime == listed);
+                if (listed) ++next;
+            }
+            assert(next == primes.size());
+        }
+    }
+    // A range of several runs above 2^40 carries large sieving primes from run to run, and
+    // with several threads skips runs; its tail is checked against Miller-Rabin.
+    const uint64_t wide_low = 1ULL << 44, wide_high = wide_low + 50000000;
+    uint64_t wide_count = count_primes(wide_low, wide_high, 1);
+    assert(count_primes(wide_low, wide_high, 3) == wide_count);
+    std::vector<uint64_t> tail;
+    uint64_t streamed = 0;
+    for_each_prime(wide_low, wide_high, [&](uint64_t p) {
+        ++streamed;
+        if (p >= wide_high - 3000) tail.push_back(p);
+    }, 2);
+    assert(streamed == wide_count);
+    size_t listed = 0;
+    for (uint64_t n = (wide_high - 3000) | 1; n < wide_high; n += 2) {
+        bool prime = is_prime_miller_rabin(BigInt(n), 10);
+        assert(prime == (listed < tail.size() && tail[listed] == n));
+        if (prime) ++listed;
+    }
+    assert(listed == tail.size());
+    std::cout << "Segmented sieve validation passed!" << std::endl;
+}
+
+/**
+ * @brief Checks that generated certificates verify, describe real primes, and reject tampering.
+ */
+void test_provable_primes() {
+    std::cout << "Running provable prime validation..." << std::endl;
+    CMWC rng(time(0));
+    for (int bits : {16, 40, 128, 256}) {
+        PrimeCertificate certificate = generate_provable_prime(bits, rng);
+        assert(certificate.prime().bit_length() == static_cast<size_t>(bits));
+        assert(verify_prime_certificate(certificate));
+        assert(is_prime_miller_rabin(certificate.prime(), 10));
+        if (!certificate.steps.empty()) {
+            PrimeCertificate tampered = certificate;
+            tampered.steps.back().p = tampered.steps.back().p + BigInt(uint64_t(2));
+            assert(!verify_prime_certificate(tampered));
+        }
+    }
+    // A base prime wider than the generator ever emits must be rejected up front, not
+    // trial-divided (2^61 - 1 would take ~2^29 divisions, larger ones far more).
+    PrimeCertificate oversized;
+    oversized.base_prime = BigInt(uint64_t(0x1FFFFFFFFFFFFFFFULL));
+    assert(!verify_prime_certificate(oversized));
+    std::cout << "Provable prime validation passed!" << std::endl;
+}
+
+/**
+ * @brief Per-candidate cost of one screening round on random odd candidates at every size:
+ *        a base-2 Fermat modular_pow, one random-base Miller-Rabin round, and is_sprp_base2.
+ */
+void benchmark_base2_screen() {
+    std::vector<int> bit_sizes = {40, 56, 80, 128, 168, 224, 256, 512, 1024, 2048};
+    CMWC rng(time(0));
+    const BigInt one(uint64_t(1));
+    const BigInt two(uint64_t(2));
+
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "| Bit Size | 2^(n-1) mod n (us) | MR round (us) | is_sprp_base2 (us) | Speedup vs MR |" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+
+    for (int bits : bit_sizes) {
+        const size_t count = bits <= 256 ? 200 : (bits <= 1024 ? 40 : 10);
+        std::vector<BigInt> candidates;
+        for (size_t i = 0; i < count; ++i) {
+            BigInt n = generate_random_cmwc(bits, rng);
+            n.set_bit(bits - 1, true);
+            n.set_bit(0, true);
+            candidates.push_back(n);
+        }
+
+        auto start_fermat = std::chrono::high_resolution_clock::now();
+        for (const auto& n : candidates) {
+            BigInt::modular_pow(two, n - one, n);
+        }
+        auto end_fermat = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::micro> fermat_duration = end_fermat - start_fermat;
+
+        auto start_mr = std::chrono::high_resolution_clock::now();
+        for (const auto& n : candidates) {
+            is_prime_miller_rabin(n, 1);
+        }
+        auto end_mr = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::micro> mr_duration = end_mr - start_mr;
+
+        auto start_sprp = std::chrono::high_resolution_clock::now();
+        for (const auto& n : candidates) {
+            is_sprp_base2(n);
+        }
+        auto end_sprp = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::micro> sprp_duration = end_sprp - start_sprp;
+
+        std::cout << "| " << std::setw(8) << bits
+                  << " | " << std::setw(18) << fermat_duration.count() / count
+                  << " | " << std::setw(13) << mr_duration.count() / count
+                  << " | " << std::setw(18) << sprp_duration.count() / count
+                  << " | " << std::setw(13) << mr_duration.count() / sprp_duration.count() << " |" << std::endl;
+    }
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Times a round of a^(n-1) mod n over a batch of same-sized odd candidates: one
+ *        BigInt::modular_pow each, then batch_modular_pow with each kernel, and full k-round
+ *        Miller-Rabin per candidate against the batch path.
+ */
+void benchmark_batch_powmod() {
+    std::vector<int> bit_sizes = {256, 512, 1024, 2048};
+    const size_t batch = 16;
+    int k = 5;
+    CMWC rng(time(0));
+    const bool avx2 = powmod_avx2_available();
+
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "| Bit Size | modular_pow (ms) | Batch scalar (ms) | Batch AVX2 (ms) | MR (ms) | MR batch (ms) |" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+
+    for (int bits : bit_sizes) {
+        std::vector<BigInt> bases, exponents, moduli;
+        for (size_t i = 0; i < batch; ++i) {
+            BigInt n = generate_random_cmwc(bits, rng);
+            n.set_bit(bits - 1, true);
+            n.set_bit(0, true);
+            bases.push_back(BigInt(uint64_t(3)));
+            exponents.push_back(n - BigInt(uint64_t(1)));
+            moduli.push_back(n);
+        }
+
+        auto start_single = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < batch; ++i) {
+            BigInt::modular_pow(bases[i], exponents[i], moduli[i]);
+        }
+        auto end_single = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> single_duration = end_single - start_single;
+
+        auto start_scalar = std::chrono::high_resolution_clock::now();
+        batch_modular_pow(bases, exponents, moduli, POWMOD_KERNEL_SCALAR);
+        auto end_scalar = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> scalar_duration = end_scalar - start_scalar;
+
+        double avx2_ms = -1;
+        if (avx2) {
+            auto start_avx2 = std::chrono::high_resolution_clock::now();
+            batch_modular_pow(bases, exponents, moduli, POWMOD_KERNEL_AVX2);
+            auto end_avx2 = std::chrono::high_resolution_clock::now();
+            avx2_ms = std::chrono::duration<double, std::milli>(end_avx2 - start_avx2).count();
+        }
+
+        auto start_mr = std::chrono::high_resolution_clock::now();
+        for (const auto& n : moduli) {
+            is_prime_miller_rabin(n, k);
+        }
+        auto end_mr = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> mr_duration = end_mr - start_mr;
+
+        auto start_mr_batch = std::chrono::high_resolution_clock::now();
+        is_prime_miller_rabin_batch(moduli, k);
+        auto end_mr_batch = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> mr_batch_duration = end_mr_batch - start_mr_batch;
+
+        std::cout << "| " << std::setw(8) << bits
+                  << " | " << std::setw(16) << single_duration.count()
+                  << " | " << std::setw(17) << scalar_duration.count() << " | ";
+        if (avx2_ms < 0) {
+            std::cout << std::setw(15) << "-";
+        } else {
+            std::cout << std::setw(15) << avx2_ms;
+        }
+        std::cout << " | " << std::setw(7) << mr_duration.count()
+                  << " | " << std::setw(13) << mr_batch_duration.count() << " |" << std::endl;
+    }
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Times counting the primes in [10^12, 10^12 + 10^9) with the segmented sieve, against
+ *        the Miller-Rabin-per-odd-number rate it replaces.
+ */
+void benchmark_segmented_sieve() {
+    const uint64_t low = 1000000000000ULL;
+    const uint64_t width = 1000000000ULL;
+    const unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "| Range            | Threads |     Primes |   Sieve (ms) | MR estimate (ms) |" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+
+    // Miller-Rabin cost per odd number, measured on a short stretch and scaled up.
+    const uint64_t sample = 20000;
+    auto start_mr = std::chrono::high_resolution_clock::now();
+    for (uint64_t n = low + 1; n < low + 2 * sample; n += 2) {
+        is_prime_miller_rabin(BigInt(n), 5);
+    }
+    auto end_mr = std::chrono::high_resolution_clock::now();
+    double mr_ms = std::chrono::duration<double, std::milli>(end_mr - start_mr).count() * (width / 2) / sample;
+
+    std::vector<unsigned int> thread_counts = {1};
+    if (threads > 1) thread_counts.push_back(threads);
+    for (unsigned int t : thread_counts) {
+        auto start_sieve = std::chrono::high_resolution_clock::now();
+        uint64_t count = count_primes(low, low + width, t);
+        auto end_sieve = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> sieve_duration = end_sieve - start_sieve;
+
+        std::cout << "| 1e12 + [0, 1e9)  | " << std::setw(7) << t
+                  << " | " << std::setw(10) << count
+                  << " | " << std::setw(12) << sieve_duration.count()
+                  << " | " << std::setw(16) << mr_ms << " |" << std::endl;
+    }
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Times repeated exponentiation of one base (modular_pow each time vs a comb table
+ *        built once) and a^x * b^y (two modular_pow calls vs Straus multi-exponentiation),
+ *        with full-length exponents.
+ */
+void benchmark_multi_exponentiation() {
+    std::vector<int> bit_sizes = {1024, 2048, 4096};
+    const size_t exponents_per_base = 8;
+    CMWC rng(time(0));
+
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "| Bit Size | modular_pow (ms/exp) | Comb build (ms) | Comb (ms/exp) | a^x*b^y (ms) | Straus (ms) |" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+
+    for (int bits : bit_sizes) {
+        BigInt modulus = generate_random_cmwc(bits, rng);
+        modulus.set_bit(bits - 1, true);
+        modulus.set_bit(0, true);
+        BigInt a = generate_random_cmwc(bits, rng) % modulus;
+        BigInt b = generate_random_cmwc(bits, rng) % modulus;
+        std::vector<BigInt> exponents;
+        for (size_t i = 0; i < exponents_per_base; ++i) {
+            exponents.push_back(generate_random_cmwc(bits, rng));
+        }
+
+        auto start_single = std::chrono::high_resolution_clock::now();
+        std::vector<BigInt> expected;
+        for (const auto& e : exponents) {
+            expected.push_back(BigInt::modular_pow(a, e, modulus));
+        }
+        auto end_single = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> single_duration = end_single - start_single;
+
+        auto start_build = std::chrono::high_resolution_clock::now();
+        FixedBaseTable comb(a, modulus, bits);
+        auto end_build = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> build_duration = end_build - start_build;
+
+        auto start_comb = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < exponents.size(); ++i) {
+            BigInt result = comb.pow(exponents[i]);
+            assert(result == expected[i]);
+        }
+        auto end_comb = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> comb_duration = end_comb - start_comb;
+
+        auto start_pair = std::chrono::high_resolution_clock::now();
+        BigInt product = BigInt::mulmod(BigInt::modular_pow(a, exponents[0], modulus),
+                                        BigInt::modular_pow(b, exponents[1], modulus), modulus);
+        auto end_pair = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> pair_duration = end_pair - start_pair;
+
+        auto start_straus = std::chrono::high_resolution_clock::now();
+        BigInt straus = multi_modular_pow({a, b}, {exponents[0], exponents[1]}, modulus);
+        auto end_straus = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> straus_duration = end_straus - start_straus;
+        assert(straus == product);
+
+        std::cout << "| " << std::setw(8) << bits
+                  << " | " << std::setw(20) << single_duration.count() / exponents.size()
+                  << " | " << std::setw(15) << build_duration.count()
+                  << " | " << std::setw(13) << comb_duration.count() / exponents.size()
+                  << " | " << std::setw(12) << pair_duration.count()
+                  << " | " << std::setw(11) << straus_duration.count() << " |" << std::endl;
+    }
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Checks generated safe and strong primes against their defining properties.
+ */
+void test_safe_primes() {
+    std::cout << "Running safe/strong prime validation..." << std::endl;
+    CMWC rng(time(0));
+    const BigInt one(uint64_t(1));
+
+    assert(is_safe_prime(BigInt(uint64_t(23)), 10));
+    assert(is_safe_prime(BigInt(uint64_t(2039)), 10));
+    assert(!is_safe_prime(BigInt(uint64_t(29)), 10));
+    assert(!is_safe_prime(BigInt(uint64_t(2041)), 10));
+
+    for (int bits : {8, 20, 64, 256}) {
+        for (unsigned int threads : {1u, 3u}) {
+            SafePrime safe = generate_safe_prime(bits, 10, rng, threads);
+            assert(safe.p.bit_length() == static_cast<size_t>(bits));
+            assert(safe.p == safe.q + safe.q + one);
+            assert(is_safe_prime(safe.p, 10));
+        }
+    }
+
+    for (int bits : {128, 512}) {
+        StrongPrime strong = generate_strong_prime(bits, 10, rng);
+        assert(strong.p.bit_length() == static_cast<size_t>(bits));
+        assert(is_prime_miller_rabin(strong.p, 10));
+        assert(is_prime_miller_rabin(strong.r, 10));
+        assert(is_prime_miller_rabin(strong.s, 10));
+        assert(is_prime_miller_rabin(strong.t, 10));
+        assert(((strong.p - one) % strong.r).is_zero());
+        assert(((strong.p + one) % strong.s).is_zero());
+        assert(((strong.r - one) % strong.t).is_zero());
+    }
+    std::cout << "Safe/strong prime validation passed!" << std::endl;
+}
+
+/**
+ * @brief Naive safe prime search: next Miller-Rabin prime p from a random start, retried until
+ *        (p - 1) / 2 is also prime.
+ */
+BigInt find_safe_prime_naive(int bits, int k, CMWC& rng) {
+    for (;;) {
+        BigInt start = generate_random_cmwc(bits, rng);
+        start.set_bit(bits - 1, true);
+        BigInt p = find_next_prime(start, k, is_prime_miller_rabin);
+        BigInt q = p - BigInt(uint64_t(1));
+        q >>= 1;
+        if (p.bit_length() == static_cast<size_t>(bits) && is_prime_miller_rabin(q, k)) return p;
+    }
+}
+
+/**
+ * @brief Times safe prime generation: the naive prime-then-check loop (small sizes only), the
+ *        joint sieve on one thread and on every hardware thread, and Gordon's strong primes.
+ */
+void benchmark_safe_primes() {
+    std::vector<int> bit_sizes = {256, 512, 1024, 2048};
+    const int naive_limit = 256;
+    const unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    int k = 5;
+    CMWC rng(time(0));
+
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "| Bit Size | Naive safe (ms) | Sieved safe (ms) | Sieved x" << std::setw(2) << threads
+              << " (ms) | Strong (ms) |" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+
+    for (int bits : bit_sizes) {
+        double naive_ms = -1;
+        if (bits <= naive_limit) {
+            auto start_naive = std::chrono::high_resolution_clock::now();
+            find_safe_prime_naive(bits, k, rng);
+            auto end_naive = std::chrono::high_resolution_clock::now();
+            naive_ms = std::chrono::duration<double, std::milli>(end_naive - start_naive).count();
+        }
+
+        auto start_single = std::chrono::high_resolution_clock::now();
+        generate_safe_prime(bits, k, rng, 1);
+        auto end_single = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> single_duration = end_single - start_single;
+
+        auto start_parallel = std::chrono::high_resolution_clock::now();
+        generate_safe_prime(bits, k, rng, threads);
+        auto end_parallel = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> parallel_duration = end_parallel - start_parallel;
+
+        auto start_strong = std::chrono::high_resolution_clock::now();
+        generate_strong_prime(bits, k, rng);
+        auto end_strong = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> strong_duration = end_strong - start_strong;
+
+        std::cout << "| " << std::setw(8) << bits << " | ";
+        if (naive_ms < 0) {
+            std::cout << std::setw(15) << "-";
+        } else {
+            std::cout << std::setw(15) << naive_ms;
+        }
+        std::cout << " | " << std::setw(16) << single_duration.count()
+                  << " | " << std::setw(16) << parallel_duration.count()
+                  << " | " << std::setw(11) << strong_duration.count() << " |" << std::endl;
+    }
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Times Shawe-Taylor provable prime generation (and certificate verification) against
+ *        the probabilistic path: a random CMWC start fed to find_next_prime with Miller-Rabin.
+ */
+void benchmark_provable_primes() {
+    std::vector<int> bit_sizes = {256, 512, 1024, 2048};
+    int k = 5;
+    CMWC rng(time(0));
+
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "| Bit Size | Probabilistic (ms) | Provable (ms) | Verify (ms) | Certificate steps |" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+
+    for (int bits : bit_sizes) {
+        BigInt start = generate_random_cmwc(bits, rng);
+        start.set_bit(bits - 1, true);
+
+        auto start_probable = std::chrono::high_resolution_clock::now();
+        find_next_prime(start, k, is_prime_miller_rabin);
+        auto end_probable = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> probable_duration = end_probable - start_probable;
+
+        auto start_provable = std::chrono::high_resolution_clock::now();
+        PrimeCertificate certificate = generate_provable_prime(bits, rng);
+        auto end_provable = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> provable_duration = end_provable - start_provable;
+
+        auto start_verify = std::chrono::high_resolution_clock::now();
+        bool verified = verify_prime_certificate(certificate);
+        auto end_verify = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> verify_duration = end_verify - start_verify;
+        assert(verified);
+
+        std::cout << "| " << std::setw(8) << bits
+                  << " | " << std::setw(18) << probable_duration.count()
+                  << " | " << std::setw(13) << provable_duration.count()
+                  << " | " << std::setw(11) << verify_duration.count()
+                  << " | " << std::setw(17) << certificate.steps.size() << " |" << std::endl;
+    }
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Compares drawing random numbers from a pre-filled RandomPool against generating them inline.
+ *
+ * Both paths use the same stateful generators the pool producers run, so the difference is the
+ * latency the consumer sees, not a difference in generator cost.
+ */
+void benchmark_random_pool() {
+    std::vector<int> bit_sizes = {256, 1024, 4096};
+    const size_t depth = 4096;
+    const unsigned int producers = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "| Generator | Bit Size | Inline (us/number) | Queued (us/number) | Producer stalls |" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+
+    const char* names[] = {"xorshift", "cmwc"};
+    for (int g = 0; g < 2; ++g) {
+        for (int bits : bit_sizes) {
+            auto factory = [g, bits](unsigned int index) {
+                uint64_t seed = time(0) ^ (0x9E3779B97F4A7C15ULL * (index + 1));
+                return g == 0 ? make_xorshift_generator(bits, seed) : make_cmwc_generator(bits, seed);
+            };
+
+            RandomPool::Generator inline_generator = factory(producers);
+            auto start_inline = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < depth; ++i) {
+                inline_generator();
+            }
+            auto end_inline = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double, std::micro> inline_duration = end_inline - start_inline;
+
+            RandomPool pool(bits, factory, depth, producers);
+            while (pool.available() < pool.depth()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            auto start_queued = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < depth; ++i) {
+                pool.next();
+            }
+            auto end_queued = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double, std::micro> queued_duration = end_queued - start_queued;
+            pool.stop();
+
+            std::cout << "| " << std::setw(9) << names[g]
+                      << " | " << std::setw(8) << bits
+                      << " | " << std::setw(18) << inline_duration.count() / depth
+                      << " | " << std::setw(18) << queued_duration.count() / depth
+                      << " | " << std::setw(15) << pool.stats().producer_stalls << " |" << std::endl;
+        }
+    }
+    std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
+}
+
 int main() {
+    test_ring_buffer();
     test_primality_testers();
+    test_batch_primality_testers();
+    test_segmented_sieve();
+    test_provable_primes();
+    test_safe_primes();
 
     std::vector<int> bit_sizes = {40, 56, 80, 128, 168, 224, 256};
     int k = 5; // Number of rounds for primality tests
     // , 512, 1024, 2048, 4096
 
     std::cout << std::fixed << std::setprecision(6);
+    benchmark_random_pool();
+    benchmark_base2_screen();
+    benchmark_batch_powmod();
+    benchmark_multi_exponentiation();
+    benchmark_provable_primes();
+    benchmark_safe_primes();
+    benchmark_segmented_sieve();
+
     std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
     std::cout << "| Bit Size | Fermat Time (ms) | Miller-Rabin Time (ms) | Difference (ms) |" << std::endl;
     std::cout << "--------------------------------------------------------------------------------------------" << std::endl;
 
+    // Starting values come from a pool so the search never waits on generation.
+    const uint64_t search_seed = time(0);
+    RandomService starts([search_seed](int bits, unsigned int index) {
+        return make_xorshift_generator(bits, search_seed ^ (0x9E3779B97F4A7C15ULL * (index + 1)));
+    }, 16);
+
     for (int bits : bit_sizes) {
-        std::chrono::duration<double, std::milli> generation_duration;
-        BigInt random_number = generate_random(bits, generation_duration);
+        BigInt random_number = starts.next(bits);
 
         // --- Fermat Test ---
         auto start_fermat = std::chrono::high_resolution_clock::now();
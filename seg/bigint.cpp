@@ -1,38 +1,22 @@
 #include "bigint.h"
 #include <stdexcept>
 #include <algorithm>
-#include <iomanip>
-#include <sstream>
+#include <deque>
+#include <mutex>
 #include <cstdint> // Required for __int128
 
-BigInt::BigInt(unsigned int bits) : num_bits(bits) {
+BigInt::BigInt(unsigned int bits) : num_bits(bits), used(0) {
     if (bits == 0) {
         throw std::invalid_argument("Number of bits must be positive.");
     }
     limbs.resize((bits + 63) / 64, 0);
 }
 
-BigInt::BigInt(uint64_t value) : num_bits(64) {
+BigInt::BigInt(uint64_t value) : num_bits(64), used(value != 0) {
     limbs.resize(1, value);
 }
 
-BigInt::BigInt(const std::string& hex_str) {
-    std::string clean_hex = (hex_str.substr(0, 2) == "0x") ? hex_str.substr(2) : hex_str;
-    size_t num_limbs = (clean_hex.length() + 15) / 16;
-    limbs.resize(num_limbs, 0);
-    num_bits = clean_hex.length() * 4;
-
-    for (size_t i = 0; i < num_limbs; ++i) {
-        size_t pos = clean_hex.length() - (i + 1) * 16;
-        size_t len = 16;
-        if (pos > clean_hex.length()) { // check for underflow
-            len = 16 - (pos + len);
-            pos = 0;
-        }
-        std::string limb_str = clean_hex.substr(pos, len);
-        limbs[i] = std::stoull(limb_str, nullptr, 16);
-    }
-}
+BigInt::BigInt(const std::string& hex_str) : BigInt(from_hex(hex_str.data(), hex_str.size())) {}
 
 void BigInt::seed(uint64_t seed_val) {
     if (!limbs.empty()) {
@@ -40,36 +24,48 @@ void BigInt::seed(uint64_t seed_val) {
         for (size_t i = 1; i < limbs.size(); ++i) {
             limbs[i] = 0;
         }
+        used = seed_val != 0;
     }
 }
 
+/**
+ * @brief XORs `other` into this value, keeping this value's width.
+ *
+ * Bits of `other` above this value's limb count are dropped, which is what gives the
+ * Xorshift state its fixed size.
+ */
 BigInt& BigInt::operator^=(const BigInt& other) {
-    size_t min_limbs = std::min(limbs.size(), other.limbs.size());
+    size_t min_limbs = std::min(limbs.size(), other.used);
     for (size_t i = 0; i < min_limbs; ++i) {
         limbs[i] ^= other.limbs[i];
     }
-    trim();
+    normalize();
     return *this;
 }
 
+/**
+ * @brief Shifts left by any number of bits in a single pass, growing the limbs as needed.
+ */
 BigInt& BigInt::operator<<=(size_t shift) {
-    if (shift == 0) return *this;
-    
+    if (shift == 0 || used == 0) return *this;
+
     size_t limb_shift = shift / 64;
     size_t bit_shift = shift % 64;
+    size_t new_used = used + limb_shift + 1;
 
-    if (limb_shift >= limbs.size()) {
-        std::fill(limbs.begin(), limbs.end(), 0);
-        return *this;
+    if (limbs.size() < new_used) {
+        limbs.resize(new_used, 0);
     }
 
     if (bit_shift == 0) {
-        for (size_t i = limbs.size() - 1; i >= limb_shift; --i) {
-            limbs[i] = limbs[i - limb_shift];
+        limbs[used + limb_shift] = 0;
+        for (size_t i = used; i-- > 0;) {
+            limbs[i + limb_shift] = limbs[i];
         }
     } else {
-        for (size_t i = limbs.size() - 1; i > limb_shift; --i) {
-            limbs[i] = (limbs[i - limb_shift] << bit_shift) | (limbs[i - limb_shift - 1] >> (64 - bit_shift));
+        limbs[used + limb_shift] = limbs[used - 1] >> (64 - bit_shift);
+        for (size_t i = used - 1; i > 0; --i) {
+            limbs[i + limb_shift] = (limbs[i] << bit_shift) | (limbs[i - 1] >> (64 - bit_shift));
         }
         limbs[limb_shift] = limbs[0] << bit_shift;
     }
@@ -78,54 +74,152 @@ BigInt& BigInt::operator<<=(size_t shift) {
         limbs[i] = 0;
     }
 
-    trim();
+    used = limbs[new_used - 1] != 0 ? new_used : new_used - 1;
     return *this;
 }
 
+/**
+ * @brief Shifts right by any number of bits in a single pass. The width is kept.
+ */
 BigInt& BigInt::operator>>=(size_t shift) {
-    if (shift == 0) return *this;
+    if (shift == 0 || used == 0) return *this;
 
     size_t limb_shift = shift / 64;
     size_t bit_shift = shift % 64;
 
-    if (limb_shift >= limbs.size()) {
-        std::fill(limbs.begin(), limbs.end(), 0);
+    if (limb_shift >= used) {
+        std::fill(limbs.begin(), limbs.begin() + used, 0);
+        used = 0;
         return *this;
     }
 
+    size_t new_used = used - limb_shift;
     if (bit_shift == 0) {
-        for (size_t i = 0; i < limbs.size() - limb_shift; ++i) {
+        for (size_t i = 0; i < new_used; ++i) {
             limbs[i] = limbs[i + limb_shift];
         }
     } else {
-        for (size_t i = 0; i < limbs.size() - limb_shift - 1; ++i) {
+        for (size_t i = 0; i + 1 < new_used; ++i) {
             limbs[i] = (limbs[i + limb_shift] >> bit_shift) | (limbs[i + limb_shift + 1] << (64 - bit_shift));
         }
-        limbs[limbs.size() - limb_shift - 1] = limbs.back() >> bit_shift;
+        limbs[new_used - 1] = limbs[used - 1] >> bit_shift;
     }
 
-    for (size_t i = limbs.size() - limb_shift; i < limbs.size(); ++i) {
+    for (size_t i = new_used; i < used; ++i) {
         limbs[i] = 0;
     }
-    
+
+    used = limbs[new_used - 1] != 0 ? new_used : new_used - 1;
     return *this;
 }
 
-BigInt BigInt::operator+(const BigInt& other) const {
-    size_t max_limbs = std::max(limbs.size(), other.limbs.size());
-    BigInt result(max_limbs * 64);
+namespace {
+
+/**
+ * @brief Schoolbook product of a[0..an) and b[0..bn) into out[0..an+bn), which must start zeroed.
+ */
+void multiply_limbs(const uint64_t* a, size_t an, const uint64_t* b, size_t bn, uint64_t* out) {
+    for (size_t i = 0; i < an; ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < bn; ++j) {
+            unsigned __int128 p = (unsigned __int128)a[i] * b[j] + out[i + j] + carry;
+            out[i + j] = (uint64_t)p;
+            carry = (uint64_t)(p >> 64);
+        }
+        out[i + bn] = carry;
+    }
+}
+
+/**
+ * @brief Square of a[0..n) into out[0..2n), which must start zeroed. Each cross product
+ * a[i] * a[j] (i < j) is formed once and the sum doubled, so only about half the limb
+ * multiplications of multiply_limbs are needed.
+ */
+void square_limbs(const uint64_t* a, size_t n, uint64_t* out) {
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t carry = 0;
+        for (size_t j = i + 1; j < n; ++j) {
+            unsigned __int128 p = (unsigned __int128)a[i] * a[j] + out[i + j] + carry;
+            out[i + j] = (uint64_t)p;
+            carry = (uint64_t)(p >> 64);
+        }
+        out[i + n] = carry;
+    }
+    for (size_t k = 2 * n; k-- > 1;) {
+        out[k] = (out[k] << 1) | (out[k - 1] >> 63);
+    }
+    out[0] <<= 1;
     uint64_t carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        unsigned __int128 p = (unsigned __int128)a[i] * a[i] + out[2 * i] + carry;
+        out[2 * i] = (uint64_t)p;
+        p = (unsigned __int128)out[2 * i + 1] + (uint64_t)(p >> 64);
+        out[2 * i + 1] = (uint64_t)p;
+        carry = (uint64_t)(p >> 64);
+    }
+}
 
-    for (size_t i = 0; i < max_limbs; ++i) {
-        uint64_t l1 = (i < limbs.size()) ? limbs[i] : 0;
-        uint64_t l2 = (i < other.limbs.size()) ? other.limbs[i] : 0;
-        uint64_t sum = l1 + l2 + carry;
-        result.limbs[i] = sum;
-        carry = (sum < l1) || (sum == l1 && carry);
+/**
+ * @brief The main loop of Knuth's Algorithm D on normalized limbs.
+ *
+ * Divides un[0..m+n] by vn[0..n) in place, where n >= 2 and the top bit of vn[n-1] is set.
+ * The normalized remainder is left in un[0..n). Quotient limbs are stored to q[0..m] unless
+ * q is null.
+ */
+void divide_normalized(uint64_t* un, size_t m, const uint64_t* vn, size_t n, uint64_t* q) {
+    for (size_t j = m + 1; j-- > 0;) {
+        unsigned __int128 num = ((unsigned __int128)un[j + n] << 64) | un[j + n - 1];
+        unsigned __int128 qhat = num / vn[n - 1];
+        unsigned __int128 rhat = num % vn[n - 1];
+        while (qhat >> 64 || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+            --qhat;
+            rhat += vn[n - 1];
+            if (rhat >> 64) break;
+        }
+
+        // Multiply and subtract qhat * vn from the current window of un.
+        __int128 borrow = 0;
+        __int128 t;
+        for (size_t i = 0; i < n; ++i) {
+            unsigned __int128 p = qhat * vn[i];
+            t = (__int128)un[i + j] - borrow - (uint64_t)p;
+            un[i + j] = (uint64_t)t;
+            borrow = (__int128)(uint64_t)(p >> 64) - (t >> 64);
+        }
+        t = (__int128)un[j + n] - borrow;
+        un[j + n] = (uint64_t)t;
+
+        if (t < 0) {
+            // qhat was one too large: add the divisor back.
+            --qhat;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < n; ++i) {
+                unsigned __int128 sum = (unsigned __int128)un[i + j] + vn[i] + carry;
+                un[i + j] = (uint64_t)sum;
+                carry = (uint64_t)(sum >> 64);
+            }
+            un[j + n] += carry;
+        }
+        if (q) q[j] = (uint64_t)qhat;
     }
-    if (carry > 0) {
-        result.limbs.push_back(carry);
+}
+
+} // namespace
+
+BigInt BigInt::operator+(const BigInt& other) const {
+    const BigInt& longer = used >= other.used ? *this : other;
+    const BigInt& shorter = used >= other.used ? other : *this;
+    BigInt result(static_cast<unsigned int>((longer.used + 1) * 64));
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < longer.used; ++i) {
+        uint64_t l1 = longer.limbs[i];
+        uint64_t l2 = (i < shorter.used) ? shorter.limbs[i] : 0;
+        unsigned __int128 sum = (unsigned __int128)l1 + l2 + carry;
+        result.limbs[i] = (uint64_t)sum;
+        carry = (uint64_t)(sum >> 64);
     }
+    result.limbs[longer.used] = carry;
     result.trim();
     return result;
 }
@@ -134,12 +228,12 @@ BigInt BigInt::operator-(const BigInt& other) const {
     if (*this < other) {
         throw std::runtime_error("Subtraction would result in a negative number.");
     }
-    BigInt result(num_bits);
+    BigInt result(static_cast<unsigned int>(std::max<size_t>(used, 1) * 64));
     uint64_t borrow = 0;
 
-    for (size_t i = 0; i < limbs.size(); ++i) {
+    for (size_t i = 0; i < used; ++i) {
         uint64_t l1 = limbs[i];
-        uint64_t l2 = (i < other.limbs.size()) ? other.limbs[i] : 0;
+        uint64_t l2 = (i < other.used) ? other.limbs[i] : 0;
         uint64_t diff = l1 - l2 - borrow;
         result.limbs[i] = diff;
         borrow = (l1 < l2) || (l1 == l2 && borrow);
@@ -149,81 +243,95 @@ BigInt BigInt::operator-(const BigInt& other) const {
 }
 
 BigInt BigInt::operator*(const BigInt& other) const {
-    BigInt result(num_bits + other.num_bits);
-    for (size_t i = 0; i < limbs.size(); ++i) {
-        uint64_t carry = 0;
-        for (size_t j = 0; j < other.limbs.size(); ++j) {
-            __int128 p = (__int128)limbs[i] * other.limbs[j] + result.limbs[i + j] + carry;
-            result.limbs[i + j] = (uint64_t)p;
-            carry = p >> 64;
-        }
-        if (carry > 0) {
-            result.limbs[i + other.limbs.size()] += carry;
-        }
+    if (used == 0 || other.used == 0) {
+        return BigInt(uint64_t(0));
     }
+    BigInt result(static_cast<unsigned int>((used + other.used) * 64));
+    multiply_limbs(limbs.data(), used, other.limbs.data(), other.used, result.limbs.data());
     result.trim();
     return result;
 }
 
-BigInt BigInt::operator/(const BigInt& other) const {
-    if (other.is_zero()) {
+/**
+ * @brief Computes quotient and/or remainder with Knuth's Algorithm D (TAOCP vol. 2, 4.3.1).
+ *
+ * The divisor is normalized with a single shift by the leading-zero count of its top limb,
+ * so each quotient limb is estimated from a 128-by-64-bit division and corrected at most
+ * twice. Either output pointer may be null.
+ */
+void BigInt::divmod(const BigInt& dividend, const BigInt& divisor, BigInt* quotient, BigInt* remainder) {
+    if (divisor.is_zero()) {
         throw std::runtime_error("Division by zero.");
     }
-    if (*this < other) {
-        return BigInt(uint64_t(0));
+    if (dividend < divisor) {
+        if (quotient) *quotient = BigInt(uint64_t(0));
+        if (remainder) *remainder = dividend;
+        return;
     }
 
-    BigInt quotient(num_bits);
-    BigInt remainder(*this);
+    size_t n = divisor.used;
+    size_t m = dividend.used - n;
 
-    int this_bits = this->bit_length();
-    int other_bits = other.bit_length();
-
-    BigInt temp_other = other;
-    temp_other <<= (this_bits - other_bits);
-
-    for (int i = this_bits - other_bits; i >= 0; --i) {
-        if (remainder >= temp_other) {
-            remainder = remainder - temp_other;
-            quotient.set_bit(i, 1);
+    if (n == 1) {
+        uint64_t d = divisor.limbs[0];
+        BigInt q(static_cast<unsigned int>(dividend.used * 64));
+        uint64_t r = 0;
+        for (size_t i = dividend.used; i-- > 0;) {
+            unsigned __int128 cur = ((unsigned __int128)r << 64) | dividend.limbs[i];
+            q.limbs[i] = (uint64_t)(cur / d);
+            r = (uint64_t)(cur % d);
         }
-        temp_other >>= 1;
+        q.trim();
+        if (quotient) *quotient = q;
+        if (remainder) *remainder = BigInt(r);
+        return;
     }
 
-    quotient.trim();
-    return quotient;
-}
-
-BigInt BigInt::operator%(const BigInt& other) const {
-     if (other.is_zero()) {
-        throw std::runtime_error("Division by zero.");
+    int s = __builtin_clzll(divisor.limbs[n - 1]);
+    std::vector<uint64_t> vn(n);
+    std::vector<uint64_t> un(dividend.used + 1);
+    for (size_t i = n - 1; i > 0; --i) {
+        vn[i] = (divisor.limbs[i] << s) | (s ? divisor.limbs[i - 1] >> (64 - s) : 0);
     }
-    if (*this < other) {
-        return *this;
+    vn[0] = divisor.limbs[0] << s;
+    un[dividend.used] = s ? dividend.limbs[dividend.used - 1] >> (64 - s) : 0;
+    for (size_t i = dividend.used - 1; i > 0; --i) {
+        un[i] = (dividend.limbs[i] << s) | (s ? dividend.limbs[i - 1] >> (64 - s) : 0);
     }
+    un[0] = dividend.limbs[0] << s;
 
-    BigInt remainder(*this);
-
-    int this_bits = this->bit_length();
-    int other_bits = other.bit_length();
-
-    BigInt temp_other = other;
-    temp_other <<= (this_bits - other_bits);
+    BigInt q(static_cast<unsigned int>((m + 1) * 64));
+    divide_normalized(un.data(), m, vn.data(), n, q.limbs.data());
 
-    for (int i = this_bits - other_bits; i >= 0; --i) {
-        if (remainder >= temp_other) {
-            remainder = remainder - temp_other;
+    if (quotient) {
+        q.trim();
+        *quotient = q;
+    }
+    if (remainder) {
+        BigInt r(static_cast<unsigned int>(n * 64));
+        for (size_t i = 0; i < n; ++i) {
+            r.limbs[i] = (un[i] >> s) | (s ? un[i + 1] << (64 - s) : 0);
         }
-        temp_other >>= 1;
+        r.trim();
+        *remainder = r;
     }
-    
-    remainder.trim();
+}
+
+BigInt BigInt::operator/(const BigInt& other) const {
+    BigInt quotient(uint64_t(0));
+    divmod(*this, other, &quotient, nullptr);
+    return quotient;
+}
+
+BigInt BigInt::operator%(const BigInt& other) const {
+    BigInt remainder(uint64_t(0));
+    divmod(*this, other, nullptr, &remainder);
     return remainder;
 }
 
 bool BigInt::operator==(const BigInt& other) const {
-    if (limbs.size() != other.limbs.size()) return false;
-    for (size_t i = 0; i < limbs.size(); ++i) {
+    if (used != other.used) return false;
+    for (size_t i = 0; i < used; ++i) {
         if (limbs[i] != other.limbs[i]) return false;
     }
     return true;
@@ -234,10 +342,10 @@ bool BigInt::operator!=(const BigInt& other) const {
 }
 
 bool BigInt::operator<(const BigInt& other) const {
-    if (limbs.size() != other.limbs.size()) {
-        return limbs.size() < other.limbs.size();
+    if (used != other.used) {
+        return used < other.used;
     }
-    for (int i = limbs.size() - 1; i >= 0; --i) {
+    for (size_t i = used; i-- > 0;) {
         if (limbs[i] != other.limbs[i]) {
             return limbs[i] < other.limbs[i];
         }
@@ -257,111 +365,545 @@ bool BigInt::operator>=(const BigInt& other) const {
     return !(*this < other);
 }
 
+/**
+ * @brief Three-way comparison with a single limb: -1, 0 or 1 as this value is smaller,
+ * equal or larger. Lets `n <= 3` and `x == 1` skip building a BigInt for the constant.
+ */
+int BigInt::compare_small(uint64_t value) const {
+    if (used > 1) return 1;
+    uint64_t low = used ? limbs[0] : 0;
+    return low < value ? -1 : (low > value ? 1 : 0);
+}
+
+bool BigInt::operator==(uint64_t value) const {
+    return compare_small(value) == 0;
+}
+
+bool BigInt::operator!=(uint64_t value) const {
+    return compare_small(value) != 0;
+}
+
+bool BigInt::operator<(uint64_t value) const {
+    return compare_small(value) < 0;
+}
+
+bool BigInt::operator>(uint64_t value) const {
+    return compare_small(value) > 0;
+}
+
+bool BigInt::operator<=(uint64_t value) const {
+    return compare_small(value) <= 0;
+}
+
+bool BigInt::operator>=(uint64_t value) const {
+    return compare_small(value) >= 0;
+}
+
 bool BigInt::is_zero() const {
-    for (uint64_t limb : limbs) {
-        if (limb != 0) return false;
-    }
-    return true;
+    return used == 0;
 }
 
 bool BigInt::is_even() const {
-    return limbs.empty() || (limbs[0] & 1) == 0;
+    return used == 0 || (limbs[0] & 1) == 0;
 }
 
 void BigInt::set_bit(size_t n, bool value) {
     size_t limb_idx = n / 64;
     size_t bit_idx = n % 64;
     if (limb_idx >= limbs.size()) {
+        if (!value) return;
         limbs.resize(limb_idx + 1, 0);
     }
     if (value) {
         limbs[limb_idx] |= (1ULL << bit_idx);
+        used = std::max(used, limb_idx + 1);
     } else {
         limbs[limb_idx] &= ~(1ULL << bit_idx);
+        if (limb_idx + 1 == used) normalize();
     }
 }
 
 bool BigInt::get_bit(size_t n) const {
     size_t limb_idx = n / 64;
     size_t bit_idx = n % 64;
-    if (limb_idx >= limbs.size()) {
+    if (limb_idx >= used) {
         return false;
     }
     return (limbs[limb_idx] >> bit_idx) & 1;
 }
 
+/**
+ * @brief Number of bits up to and including the most significant set bit (0 for zero).
+ */
 size_t BigInt::bit_length() const {
-    if (is_zero()) return 0;
-    size_t last_limb_idx = limbs.size() - 1;
-    uint64_t last_limb = limbs[last_limb_idx];
-    size_t bits = last_limb_idx * 64;
-    while (last_limb > 0) {
-        last_limb >>= 1;
-        bits++;
+    if (used == 0) return 0;
+    return used * 64 - __builtin_clzll(limbs[used - 1]);
+}
+
+/**
+ * @brief Number of zero bits below the least significant set bit (0 for zero).
+ */
+size_t BigInt::count_trailing_zeros() const {
+    for (size_t i = 0; i < used; ++i) {
+        if (limbs[i] != 0) {
+            return i * 64 + __builtin_ctzll(limbs[i]);
+        }
     }
-    return bits;
+    return 0;
 }
 
 
+/**
+ * @brief Left-to-right binary exponentiation: one squaring per exponent bit, plus a
+ * multiplication for every set bit.
+ */
 BigInt BigInt::modular_pow(BigInt base, BigInt exponent, const BigInt& modulus) {
+    if (modulus == 1) {
+        return BigInt(uint64_t(0));
+    }
     BigInt result(uint64_t(1));
     base = base % modulus;
-    while (!exponent.is_zero()) {
-        if (!exponent.is_even()) {
-            result = (result * base) % modulus;
+    for (size_t i = exponent.bit_length(); i-- > 0;) {
+        result = sqrmod(result, modulus);
+        if (exponent.get_bit(i)) {
+            result = mulmod(result, base, modulus);
         }
-        exponent >>= 1;
-        base = (base * base) % modulus;
     }
     return result;
 }
 
-std::string BigInt::to_hex_string() const {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    bool first = true;
-    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it) {
-        if (first) {
-            if (*it != 0) {
-                ss << "0x" << *it;
-                first = false;
-            }
-        } else {
-            ss << std::setw(16) << *it;
+/**
+ * @brief Remainder of the len-limb value in un modulo `modulus`, computed in place.
+ *
+ * un must have room for len + 1 limbs; it is used as Algorithm D's working buffer, so no
+ * copy of the dividend and no quotient are ever allocated.
+ */
+BigInt BigInt::reduce_limbs(std::vector<uint64_t>& un, size_t len, const BigInt& modulus) {
+    size_t n = modulus.used;
+    if (n == 0) {
+        throw std::runtime_error("Division by zero.");
+    }
+    while (len > 0 && un[len - 1] == 0) {
+        --len;
+    }
+
+    BigInt result(static_cast<unsigned int>(std::max<size_t>(n, 1) * 64));
+    if (len < n) {
+        std::copy(un.begin(), un.begin() + len, result.limbs.begin());
+    } else if (n == 1) {
+        unsigned __int128 rem = 0;
+        for (size_t i = len; i-- > 0;) {
+            rem = ((rem << 64) | un[i]) % modulus.limbs[0];
+        }
+        result.limbs[0] = (uint64_t)rem;
+    } else {
+        int s = __builtin_clzll(modulus.limbs[n - 1]);
+        std::vector<uint64_t> vn(n);
+        for (size_t i = n - 1; i > 0; --i) {
+            vn[i] = (modulus.limbs[i] << s) | (s ? modulus.limbs[i - 1] >> (64 - s) : 0);
+        }
+        vn[0] = modulus.limbs[0] << s;
+        un[len] = s ? un[len - 1] >> (64 - s) : 0;
+        for (size_t i = len - 1; i > 0; --i) {
+            un[i] = (un[i] << s) | (s ? un[i - 1] >> (64 - s) : 0);
+        }
+        un[0] <<= s;
+
+        divide_normalized(un.data(), len - n, vn.data(), n, nullptr);
+        for (size_t i = 0; i < n; ++i) {
+            result.limbs[i] = (un[i] >> s) | (s ? un[i + 1] << (64 - s) : 0);
         }
     }
-    if (first) {
-        return "0x0";
+    result.normalize();
+    return result;
+}
+
+/**
+ * @brief (a * b) mod modulus: the product is formed straight into the division buffer.
+ */
+BigInt BigInt::mulmod(const BigInt& a, const BigInt& b, const BigInt& modulus) {
+    std::vector<uint64_t> un(a.used + b.used + 1, 0);
+    multiply_limbs(a.limbs.data(), a.used, b.limbs.data(), b.used, un.data());
+    return reduce_limbs(un, a.used + b.used, modulus);
+}
+
+/**
+ * @brief (a * a) mod modulus, using the half-cost squaring and the in-place reduction.
+ */
+BigInt BigInt::sqrmod(const BigInt& a, const BigInt& modulus) {
+    std::vector<uint64_t> un(2 * a.used + 1, 0);
+    square_limbs(a.limbs.data(), a.used, un.data());
+    return reduce_limbs(un, 2 * a.used, modulus);
+}
+
+/**
+ * @brief (a + b) mod modulus for a, b < modulus: one sum and at most one in-place subtraction.
+ */
+BigInt BigInt::addmod(const BigInt& a, const BigInt& b, const BigInt& modulus) {
+    BigInt sum = a + b;
+    if (sum >= modulus) {
+        sum.subtract_in_place(modulus);
     }
-    return ss.str();
+    return sum;
 }
 
-std::string BigInt::to_binary_string() const {
-    std::stringstream ss;
-    bool first = true;
-    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it) {
-        uint64_t limb = *it;
-        for (int i = 63; i >= 0; --i) {
-            bool bit = (limb >> i) & 1;
-            if (!first || bit) {
-                ss << (bit ? '1' : '0');
-                first = false;
+/**
+ * @brief (a - b) mod modulus for a, b < modulus, without going negative: a + modulus - b when b > a.
+ */
+BigInt BigInt::submod(const BigInt& a, const BigInt& b, const BigInt& modulus) {
+    if (a >= b) {
+        BigInt difference = a;
+        difference.subtract_in_place(b);
+        return difference;
+    }
+    BigInt difference = a + modulus;
+    difference.subtract_in_place(b);
+    return difference;
+}
+
+/**
+ * @brief Subtracts `other` (which must not exceed this value) without allocating.
+ */
+void BigInt::subtract_in_place(const BigInt& other) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < used; ++i) {
+        uint64_t l1 = limbs[i];
+        uint64_t l2 = (i < other.used) ? other.limbs[i] : 0;
+        limbs[i] = l1 - l2 - borrow;
+        borrow = (l1 < l2) || (l1 == l2 && borrow);
+    }
+    normalize();
+}
+
+/**
+ * @brief Remainder of division by a single limb, without modifying or copying the value.
+ */
+uint64_t BigInt::mod_small(uint64_t divisor) const {
+    if (divisor == 0) {
+        throw std::runtime_error("Division by zero.");
+    }
+    unsigned __int128 rem = 0;
+    for (size_t i = used; i-- > 0;) {
+        rem = ((rem << 64) | limbs[i]) % divisor;
+    }
+    return (uint64_t)rem;
+}
+
+/**
+ * @brief Greatest common divisor by Euclid's algorithm.
+ */
+BigInt BigInt::gcd(BigInt a, BigInt b) {
+    while (!b.is_zero()) {
+        BigInt r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+namespace {
+
+const uint64_t DECIMAL_BASE = 10000000000000000000ULL; // 10^19, the largest power of 10 in a limb
+const size_t DECIMAL_BASE_DIGITS = 19;
+// Below this many limbs, repeated single-limb division beats splitting by powers of 10^19.
+const size_t DECIMAL_SPLIT_LIMBS = 16;
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief Returns (10^19)^(2^k), computing and caching the powers on first use.
+ *
+ * Entries live in a deque so references handed out stay valid as the cache grows.
+ */
+const BigInt& decimal_power(size_t k) {
+    static std::deque<BigInt> powers;
+    static std::mutex powers_mutex;
+    std::lock_guard<std::mutex> lock(powers_mutex);
+    if (powers.empty()) {
+        powers.push_back(BigInt(DECIMAL_BASE));
+    }
+    while (powers.size() <= k) {
+        const BigInt& last = powers.back();
+        powers.push_back(last * last);
+    }
+    return powers[k];
+}
+
+void check_capacity(size_t needed, size_t capacity) {
+    if (capacity < needed) {
+        throw std::length_error("Output buffer too small.");
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Parses hexadecimal digits, with or without a "0x" prefix, of any length.
+ *
+ * @param str Pointer to the digits; need not be null-terminated.
+ * @param len Number of characters to read.
+ */
+BigInt BigInt::from_hex(const char* str, size_t len) {
+    if (len >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+        str += 2;
+        len -= 2;
+    }
+    if (len == 0) {
+        throw std::invalid_argument("Empty hexadecimal string.");
+    }
+
+    BigInt result(static_cast<unsigned int>(len * 4));
+    for (size_t i = 0; i < len; ++i) {
+        int v = hex_value(str[len - 1 - i]);
+        if (v < 0) {
+            throw std::invalid_argument("Invalid hexadecimal digit.");
+        }
+        result.limbs[i / 16] |= uint64_t(v) << (4 * (i % 16));
+    }
+    result.normalize();
+    return result;
+}
+
+/**
+ * @brief Parses a string of '0' and '1' characters of any length.
+ */
+BigInt BigInt::from_binary(const char* str, size_t len) {
+    if (len == 0) {
+        throw std::invalid_argument("Empty binary string.");
+    }
+
+    BigInt result(static_cast<unsigned int>(len));
+    for (size_t i = 0; i < len; ++i) {
+        char c = str[len - 1 - i];
+        if (c != '0' && c != '1') {
+            throw std::invalid_argument("Invalid binary digit.");
+        }
+        result.limbs[i / 64] |= uint64_t(c - '0') << (i % 64);
+    }
+    result.normalize();
+    return result;
+}
+
+/**
+ * @brief Parses decimal digits of any length.
+ *
+ * Short inputs are folded in 19 digits at a time. Long inputs are split so the low part
+ * has 19 * 2^k digits, parsed recursively, and recombined as hi * (10^19)^(2^k) + lo with
+ * the cached power, so most of the work happens on balanced halves.
+ */
+BigInt BigInt::from_decimal(const char* str, size_t len) {
+    if (len == 0) {
+        throw std::invalid_argument("Empty decimal string.");
+    }
+
+    if (len <= DECIMAL_BASE_DIGITS * DECIMAL_SPLIT_LIMBS) {
+        BigInt result(static_cast<unsigned int>((len / DECIMAL_BASE_DIGITS + 1) * 64));
+        size_t pos = 0;
+        size_t chunk = len % DECIMAL_BASE_DIGITS;
+        if (chunk == 0) chunk = DECIMAL_BASE_DIGITS;
+        while (pos < len) {
+            uint64_t value = 0;
+            uint64_t scale = 1;
+            for (size_t i = 0; i < chunk; ++i) {
+                char c = str[pos + i];
+                if (c < '0' || c > '9') {
+                    throw std::invalid_argument("Invalid decimal digit.");
+                }
+                value = value * 10 + (c - '0');
+                scale *= 10;
             }
+            result.mul_add_small(scale, value);
+            pos += chunk;
+            chunk = DECIMAL_BASE_DIGITS;
         }
+        return result;
     }
-    if (first) {
+
+    size_t k = 0;
+    while (DECIMAL_BASE_DIGITS << (k + 1) < len) ++k;
+    size_t low_len = DECIMAL_BASE_DIGITS << k;
+    BigInt high = from_decimal(str, len - low_len);
+    BigInt low = from_decimal(str + len - low_len, low_len);
+    return high * decimal_power(k) + low;
+}
+
+size_t BigInt::hex_digits() const {
+    return used == 0 ? 1 : (bit_length() + 3) / 4;
+}
+
+size_t BigInt::max_decimal_digits() const {
+    // log10(2) < 0.30103; one extra digit covers the rounding.
+    return bit_length() * 30103 / 100000 + 1;
+}
+
+/**
+ * @brief Writes the value as lowercase hex digits (no prefix, no terminator).
+ *
+ * @param buffer Destination with room for at least hex_digits() characters.
+ * @param capacity Size of the destination in characters.
+ * @return The number of characters written.
+ */
+size_t BigInt::write_hex(char* buffer, size_t capacity) const {
+    size_t digits = hex_digits();
+    check_capacity(digits, capacity);
+    for (size_t i = 0; i < digits; ++i) {
+        buffer[digits - 1 - i] = HEX_DIGITS[(limbs[i / 16] >> (4 * (i % 16))) & 0xF];
+    }
+    return digits;
+}
+
+/**
+ * @brief Writes the value as '0'/'1' characters without leading zeros (no terminator).
+ *
+ * @param buffer Destination with room for at least max(bit_length(), 1) characters.
+ * @param capacity Size of the destination in characters.
+ * @return The number of characters written.
+ */
+size_t BigInt::write_binary(char* buffer, size_t capacity) const {
+    size_t digits = std::max<size_t>(bit_length(), 1);
+    check_capacity(digits, capacity);
+    for (size_t i = 0; i < digits; ++i) {
+        buffer[digits - 1 - i] = (i / 64 < used && (limbs[i / 64] >> (i % 64)) & 1) ? '1' : '0';
+    }
+    return digits;
+}
+
+/**
+ * @brief Writes `value` in decimal starting at `out`.
+ *
+ * With width == 0 the digits are written without leading zeros; otherwise exactly `width`
+ * digits are written, zero-padded on the left. Values above DECIMAL_SPLIT_LIMBS limbs are
+ * split by the largest cached (10^19)^(2^k) that leaves two roughly equal halves.
+ *
+ * @return Pointer one past the last character written.
+ */
+char* BigInt::emit_decimal(const BigInt& value, char* out, size_t width) {
+    if (value.used > DECIMAL_SPLIT_LIMBS) {
+        size_t k = 0;
+        while (decimal_power(k + 1).used * 2 <= value.used + 1) ++k;
+        const BigInt& power = decimal_power(k);
+        BigInt high(uint64_t(0));
+        BigInt low(uint64_t(0));
+        divmod(value, power, &high, &low);
+        size_t low_width = DECIMAL_BASE_DIGITS << k;
+        if (width > 0) {
+            out = emit_decimal(high, out, width - low_width);
+        } else {
+            out = emit_decimal(high, out, 0);
+        }
+        return emit_decimal(low, out, low_width);
+    }
+
+    BigInt rest = value;
+    uint64_t groups[DECIMAL_SPLIT_LIMBS * 2];
+    size_t count = 0;
+    while (!rest.is_zero()) {
+        groups[count++] = rest.div_small(DECIMAL_BASE);
+    }
+
+    char top[DECIMAL_BASE_DIGITS];
+    size_t top_len = 0;
+    if (count > 0) {
+        uint64_t g = groups[count - 1];
+        while (g > 0) {
+            top[top_len++] = char('0' + g % 10);
+            g /= 10;
+        }
+    }
+    size_t digits = count == 0 ? 0 : (count - 1) * DECIMAL_BASE_DIGITS + top_len;
+    if (width == 0 && digits == 0) {
+        *out++ = '0';
+        return out;
+    }
+    for (size_t i = digits; i < width; ++i) {
+        *out++ = '0';
+    }
+    for (size_t i = top_len; i-- > 0;) {
+        *out++ = top[i];
+    }
+    for (size_t j = count - (count > 0); j-- > 0;) {
+        uint64_t g = groups[j];
+        for (size_t i = DECIMAL_BASE_DIGITS; i-- > 0;) {
+            out[i] = char('0' + g % 10);
+            g /= 10;
+        }
+        out += DECIMAL_BASE_DIGITS;
+    }
+    return out;
+}
+
+/**
+ * @brief Writes the value in decimal without leading zeros (no terminator).
+ *
+ * @param buffer Destination with room for at least max_decimal_digits() characters.
+ * @param capacity Size of the destination in characters.
+ * @return The number of characters written.
+ */
+size_t BigInt::write_decimal(char* buffer, size_t capacity) const {
+    check_capacity(max_decimal_digits(), capacity);
+    return emit_decimal(*this, buffer, 0) - buffer;
+}
+
+std::string BigInt::to_hex_string() const {
+    std::string out(2 + hex_digits(), '0');
+    out[1] = 'x';
+    write_hex(&out[2], out.size() - 2);
+    return out;
+}
+
+std::string BigInt::to_binary_string() const {
+    if (used == 0) {
         return "0";
     }
-    std::string bin_str = ss.str();
-    
     // Pad with leading zeros to match num_bits if necessary.
-    if (bin_str.length() < num_bits) {
-        bin_str.insert(0, num_bits - bin_str.length(), '0');
-    }
-    
-    return bin_str;
+    size_t digits = bit_length();
+    std::string out(std::max(digits, num_bits), '0');
+    write_binary(&out[out.size() - digits], digits);
+    return out;
+}
+
+std::string BigInt::to_decimal_string() const {
+    std::string out(max_decimal_digits(), '0');
+    out.resize(write_decimal(&out[0], out.size()));
+    return out;
 }
 
+/**
+ * @brief Divides in place by a single limb.
+ * @return The remainder.
+ */
+uint64_t BigInt::div_small(uint64_t divisor) {
+    unsigned __int128 rem = 0;
+    for (size_t i = used; i-- > 0;) {
+        unsigned __int128 cur = (rem << 64) | limbs[i];
+        limbs[i] = (uint64_t)(cur / divisor);
+        rem = cur % divisor;
+    }
+    if (used > 0 && limbs[used - 1] == 0) --used;
+    return (uint64_t)rem;
+}
+
+/**
+ * @brief Computes this = this * factor + addend in place, growing by a limb if needed.
+ */
+void BigInt::mul_add_small(uint64_t factor, uint64_t addend) {
+    uint64_t carry = addend;
+    for (size_t i = 0; i < used; ++i) {
+        unsigned __int128 p = (unsigned __int128)limbs[i] * factor + carry;
+        limbs[i] = (uint64_t)p;
+        carry = (uint64_t)(p >> 64);
+    }
+    if (carry != 0) {
+        if (used == limbs.size()) limbs.push_back(0);
+        limbs[used++] = carry;
+    }
+}
 
 /**
  * @brief Sets the limbs of the BigInt from a vector of uint64_t.
@@ -371,15 +913,42 @@ std::string BigInt::to_binary_string() const {
 void BigInt::set_limbs(const std::vector<uint64_t>& new_limbs) {
     limbs = new_limbs;
     limbs.resize((num_bits + 63) / 64, 0);
-    trim();
+    normalize();
+}
+
+/**
+ * @brief Replaces the value with `count` little-endian limbs, reusing the existing storage.
+ *
+ * Unlike set_limbs, the width follows the input, so values of any size can be loaded into
+ * one scratch BigInt without reallocating once its capacity is large enough.
+ *
+ * @param data Pointer to the limbs, least significant first.
+ * @param count Number of limbs to copy.
+ */
+void BigInt::assign_limbs(const uint64_t* data, size_t count) {
+    limbs.assign(data, data + count);
+    if (limbs.empty()) {
+        limbs.push_back(0);
+    }
+    num_bits = limbs.size() * 64;
+    normalize();
+}
+
+/**
+ * @brief Recomputes the cached count of significant limbs after a limb-level update.
+ */
+void BigInt::normalize() {
+    used = limbs.size();
+    while (used > 0 && limbs[used - 1] == 0) {
+        --used;
+    }
 }
 
 /**
  * @brief Removes leading zero limbs from the BigInt representation.
  */
 void BigInt::trim() {
-    while (limbs.size() > 1 && limbs.back() == 0) {
-        limbs.pop_back();
-    }
+    normalize();
+    limbs.resize(std::max<size_t>(used, 1));
 }
 
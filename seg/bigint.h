@@ -31,23 +31,60 @@ public:
     bool operator<=(const BigInt& other) const;
     bool operator>=(const BigInt& other) const;
 
+    bool operator==(uint64_t value) const;
+    bool operator!=(uint64_t value) const;
+    bool operator<(uint64_t value) const;
+    bool operator>(uint64_t value) const;
+    bool operator<=(uint64_t value) const;
+    bool operator>=(uint64_t value) const;
+
     bool is_zero() const;
     bool is_even() const;
     void set_bit(size_t n, bool value);
     bool get_bit(size_t n) const;
     size_t bit_length() const;
+    size_t count_trailing_zeros() const;
+    uint64_t mod_small(uint64_t divisor) const;
 
     static BigInt modular_pow(BigInt base, BigInt exponent, const BigInt& modulus);
+    static BigInt gcd(BigInt a, BigInt b);
+    static BigInt mulmod(const BigInt& a, const BigInt& b, const BigInt& modulus);
+    static BigInt sqrmod(const BigInt& a, const BigInt& modulus);
+    static BigInt addmod(const BigInt& a, const BigInt& b, const BigInt& modulus);
+    static BigInt submod(const BigInt& a, const BigInt& b, const BigInt& modulus);
+
+    static BigInt from_hex(const char* str, size_t len);
+    static BigInt from_binary(const char* str, size_t len);
+    static BigInt from_decimal(const char* str, size_t len);
+
+    size_t hex_digits() const;
+    size_t max_decimal_digits() const;
+    size_t write_hex(char* buffer, size_t capacity) const;
+    size_t write_binary(char* buffer, size_t capacity) const;
+    size_t write_decimal(char* buffer, size_t capacity) const;
 
     std::string to_hex_string() const;
     std::string to_binary_string() const;
+    std::string to_decimal_string() const;
     void set_limbs(const std::vector<uint64_t>& new_limbs);
+    void assign_limbs(const uint64_t* data, size_t count);
+    size_t limb_count() const { return used; }
+    const uint64_t* limb_data() const { return limbs.data(); }
 
 private:
     std::vector<uint64_t> limbs;
     size_t num_bits;
+    size_t used; // number of significant limbs; limbs past it are zero
 
+    void normalize();
     void trim();
+    uint64_t div_small(uint64_t divisor);
+    void mul_add_small(uint64_t factor, uint64_t addend);
+    int compare_small(uint64_t value) const;
+    void subtract_in_place(const BigInt& other);
+    static BigInt reduce_limbs(std::vector<uint64_t>& un, size_t len, const BigInt& modulus);
+    static char* emit_decimal(const BigInt& value, char* out, size_t width);
+    static void divmod(const BigInt& dividend, const BigInt& divisor, BigInt* quotient, BigInt* remainder);
 };
 
 #endif // BIGINT_H
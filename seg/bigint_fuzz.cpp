@@ -0,0 +1,353 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bigint.h"
+#include "batch-powmod.h"
+#include "multi-exp.h"
+
+/**
+ * Differential fuzz harness for BigInt: every optimized operation is checked against a
+ * deliberately naive base-2^32 reference, or against an algebraic identity where no cheap
+ * reference exists, on random operands of every width the generators use.
+ *
+ * Usage: bigint_fuzz [iterations] [--seed N] [--threads N]
+ */
+
+namespace {
+
+// --- Reference arithmetic: little-endian base-2^32 digits with no leading zeros. ---
+
+typedef std::vector<uint32_t> Digits;
+
+void ref_trim(Digits& a) {
+    while (!a.empty() && a.back() == 0) {
+        a.pop_back();
+    }
+}
+
+Digits to_digits(const BigInt& x) {
+    Digits d;
+    for (size_t i = 0; i < x.limb_count(); ++i) {
+        d.push_back(static_cast<uint32_t>(x.limb_data()[i]));
+        d.push_back(static_cast<uint32_t>(x.limb_data()[i] >> 32));
+    }
+    ref_trim(d);
+    return d;
+}
+
+int ref_compare(const Digits& a, const Digits& b) {
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+Digits ref_add(const Digits& a, const Digits& b) {
+    Digits r(std::max(a.size(), b.size()) + 1, 0);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < r.size(); ++i) {
+        uint64_t s = carry + (i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+        r[i] = static_cast<uint32_t>(s);
+        carry = s >> 32;
+    }
+    ref_trim(r);
+    return r;
+}
+
+Digits ref_sub(const Digits& a, const Digits& b) {
+    Digits r(a.size(), 0);
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        int64_t s = int64_t(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = s < 0;
+        r[i] = static_cast<uint32_t>(s + (borrow << 32));
+    }
+    ref_trim(r);
+    return r;
+}
+
+Digits ref_mul(const Digits& a, const Digits& b) {
+    Digits r(a.size() + b.size(), 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < b.size(); ++j) {
+            uint64_t p = uint64_t(a[i]) * b[j] + r[i + j] + carry;
+            r[i + j] = static_cast<uint32_t>(p);
+            carry = p >> 32;
+        }
+        r[i + b.size()] = static_cast<uint32_t>(carry);
+    }
+    ref_trim(r);
+    return r;
+}
+
+bool ref_bit(const Digits& a, size_t n) {
+    return n / 32 < a.size() && (a[n / 32] >> (n % 32)) & 1;
+}
+
+Digits ref_shift_left(const Digits& a, size_t s) {
+    Digits r(a.size() + s / 32 + 1, 0);
+    for (size_t n = 0; n < a.size() * 32; ++n) {
+        if (ref_bit(a, n)) r[(n + s) / 32] |= 1u << ((n + s) % 32);
+    }
+    ref_trim(r);
+    return r;
+}
+
+Digits ref_shift_right(const Digits& a, size_t s) {
+    Digits r(a.size(), 0);
+    for (size_t n = s; n < a.size() * 32; ++n) {
+        if (ref_bit(a, n)) r[(n - s) / 32] |= 1u << ((n - s) % 32);
+    }
+    ref_trim(r);
+    return r;
+}
+
+uint64_t ref_mod_small(const Digits& a, uint64_t m) {
+    unsigned __int128 r = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        r = ((r << 32) | a[i]) % m;
+    }
+    return static_cast<uint64_t>(r);
+}
+
+// --- Operand generation ---
+
+const size_t WIDTHS[] = {1, 32, 40, 56, 63, 64, 65, 80, 127, 128, 129, 168, 192, 224, 256,
+                         511, 512, 1024, 2048, 4096};
+
+/**
+ * @brief A random operand of up to `bits` bits in one of several shapes: uniform, all ones
+ * (carries through every limb), a single bit, sparse with whole zero limbs, or zero. About a
+ * third are built untrimmed, with zero limbs left above the significant ones.
+ */
+BigInt random_operand(std::mt19937_64& gen, size_t bits) {
+    size_t count = (bits + 63) / 64;
+    std::vector<uint64_t> words(count, 0);
+    switch (gen() % 8) {
+    case 0:
+        words.assign(count, ~0ULL);
+        break;
+    case 1:
+        words[gen() % count] = 1ULL << (gen() % 64);
+        break;
+    case 2:
+        for (auto& w : words) {
+            w = gen() % 3 == 0 ? gen() : 0;
+        }
+        break;
+    case 3:
+        if (gen() % 4 == 0) break; // zero
+        // fall through
+    default:
+        for (auto& w : words) {
+            w = gen();
+        }
+    }
+    if (bits % 64 != 0) {
+        words.back() &= (uint64_t(1) << (bits % 64)) - 1;
+    }
+    if (gen() % 3 == 0) {
+        words.resize(count + 1 + gen() % 3, 0);
+    }
+    BigInt value(static_cast<unsigned int>(words.size() * 64));
+    value.assign_limbs(words.data(), words.size());
+    return value;
+}
+
+size_t random_width(std::mt19937_64& gen) {
+    return WIDTHS[gen() % (sizeof(WIDTHS) / sizeof(WIDTHS[0]))];
+}
+
+/**
+ * @brief A shift amount biased towards the limb boundaries: 0, exactly 64k, or 64k +- 1.
+ */
+size_t random_shift(std::mt19937_64& gen) {
+    size_t limbs = gen() % 66;
+    switch (gen() % 4) {
+    case 0: return 64 * limbs;
+    case 1: return 64 * limbs + 1;
+    case 2: return limbs == 0 ? 0 : 64 * limbs - 1;
+    default: return gen() % 4200;
+    }
+}
+
+// --- Failure reporting ---
+
+std::atomic<uint64_t> failures(0);
+std::atomic<uint64_t> checks(0);
+std::mutex report_mutex;
+
+void check(bool ok, const char* what, const BigInt& a, const BigInt& b) {
+    checks.fetch_add(1, std::memory_order_relaxed);
+    if (ok) return;
+    if (failures.fetch_add(1) < 10) {
+        std::lock_guard<std::mutex> lock(report_mutex);
+        std::cerr << "FAILED: " << what << "\n  a = " << a.to_hex_string() << "\n  b = " << b.to_hex_string() << std::endl;
+    }
+}
+
+bool matches(const BigInt& x, const Digits& expected) {
+    return to_digits(x) == expected;
+}
+
+// --- One fuzz iteration: a handful of operations on fresh operands ---
+
+void fuzz_once(std::mt19937_64& gen, uint64_t iteration) {
+    BigInt a = random_operand(gen, random_width(gen));
+    BigInt b = random_operand(gen, random_width(gen));
+    BigInt c = random_operand(gen, random_width(gen));
+    Digits da = to_digits(a);
+    Digits db = to_digits(b);
+
+    // Comparisons, including against a single limb.
+    int cmp = ref_compare(da, db);
+    check((a == b) == (cmp == 0) && (a < b) == (cmp < 0) && (a > b) == (cmp > 0) &&
+          (a <= b) == (cmp <= 0) && (a >= b) == (cmp >= 0) && (a != b) == (cmp != 0), "compare", a, b);
+    uint64_t small = gen() % 2 ? gen() : (da.empty() ? 0 : da[0]) + gen() % 3;
+    Digits dsmall = {static_cast<uint32_t>(small), static_cast<uint32_t>(small >> 32)};
+    ref_trim(dsmall);
+    int small_cmp = ref_compare(da, dsmall);
+    check((a == small) == (small_cmp == 0) && (a < small) == (small_cmp < 0) && (a > small) == (small_cmp > 0),
+          "compare small", a, BigInt(small));
+
+    // Addition and subtraction.
+    BigInt sum = a + b;
+    check(matches(sum, ref_add(da, db)), "a + b", a, b);
+    check(sum == b + a, "a + b == b + a", a, b);
+    check(sum - b == a, "(a + b) - b == a", a, b);
+    if (cmp >= 0) {
+        check(matches(a - b, ref_sub(da, db)), "a - b", a, b);
+    }
+
+    // Multiplication and distributivity.
+    BigInt product = a * b;
+    check(matches(product, ref_mul(da, db)), "a * b", a, b);
+    check(product == b * a, "a * b == b * a", a, b);
+    check(a * (b + c) == product + a * c, "a * (b + c) == a * b + a * c", a, b);
+
+    // Division: q * b + r == a with r < b.
+    if (!b.is_zero()) {
+        BigInt q = a / b;
+        BigInt r = a % b;
+        check(r < b && matches(q * b + r, da), "a == (a / b) * b + a % b", a, b);
+    }
+    uint64_t divisor = gen() >> (gen() % 64);
+    if (divisor != 0) {
+        check(a.mod_small(divisor) == ref_mod_small(da, divisor), "mod_small", a, BigInt(divisor));
+    }
+
+    // Shifts, with amounts at and around limb boundaries.
+    size_t s = random_shift(gen);
+    BigInt left = a;
+    left <<= s;
+    check(matches(left, ref_shift_left(da, s)), "a << s", a, BigInt(uint64_t(s)));
+    BigInt right = a;
+    right >>= s;
+    check(matches(right, ref_shift_right(da, s)), "a >> s", a, BigInt(uint64_t(s)));
+    BigInt round_trip = left;
+    round_trip >>= s;
+    check(round_trip == a, "(a << s) >> s == a", a, BigInt(uint64_t(s)));
+
+    // Bit queries.
+    size_t length = da.empty() ? 0 : da.size() * 32 - __builtin_clz(da.back());
+    check(a.bit_length() == length, "bit_length", a, b);
+    size_t zeros = 0;
+    while (zeros < length && !ref_bit(da, zeros)) ++zeros;
+    check(a.count_trailing_zeros() == zeros, "count_trailing_zeros", a, b);
+    size_t bit = gen() % (length + 70);
+    check(a.get_bit(bit) == ref_bit(da, bit), "get_bit", a, BigInt(uint64_t(bit)));
+    check(a.is_even() == !ref_bit(da, 0) && a.is_zero() == da.empty(), "is_even/is_zero", a, b);
+
+    // Fused modular operations against the operator forms.
+    BigInt m = b;
+    m.set_bit(0, true);
+    BigInt x = a % m;
+    BigInt y = c % m;
+    check(BigInt::mulmod(a, c, m) == (a * c) % m, "mulmod", a, m);
+    check(BigInt::sqrmod(a, m) == (a * a) % m, "sqrmod", a, m);
+    check(BigInt::addmod(x, y, m) == (x + y) % m, "addmod", x, m);
+    check(BigInt::submod(x, y, m) == (x + m - y) % m, "submod", x, m);
+
+    // Conversions round-trip.
+    check(BigInt(a.to_hex_string()) == a, "hex round trip", a, b);
+    std::string decimal = a.to_decimal_string();
+    check(BigInt::from_decimal(decimal.data(), decimal.size()) == a, "decimal round trip", a, b);
+
+    // The expensive checks run on a fraction of the iterations, at moderate widths.
+    if (iteration % 16 == 0 && m.bit_length() <= 1024) {
+        BigInt e1 = random_operand(gen, 1 + gen() % 256);
+        BigInt e2 = random_operand(gen, 1 + gen() % 256);
+        BigInt p1 = BigInt::modular_pow(a, e1, m);
+        check(BigInt::modular_pow(a, e1 + e2, m) == BigInt::mulmod(p1, BigInt::modular_pow(a, e2, m), m),
+              "a^(e1 + e2) == a^e1 * a^e2", a, m);
+        check(batch_modular_pow({a}, {e1}, {m}, POWMOD_KERNEL_SCALAR)[0] == p1, "batch_modular_pow (scalar)", a, m);
+        if (powmod_avx2_available()) {
+            check(batch_modular_pow({a}, {e1}, {m}, POWMOD_KERNEL_AVX2)[0] == p1, "batch_modular_pow (avx2)", a, m);
+        }
+        check(FixedBaseTable(a, m, 256, 4).pow(e1) == p1, "FixedBaseTable::pow", a, m);
+        check(multi_modular_pow({a, c}, {e1, e2}, m) ==
+              BigInt::mulmod(p1, BigInt::modular_pow(c, e2, m), m), "multi_modular_pow", a, m);
+    }
+    if (iteration % 8 == 0 && a.bit_length() <= 1024 && b.bit_length() <= 1024 && !(a.is_zero() && b.is_zero())) {
+        BigInt g = BigInt::gcd(a, b);
+        check((a % g).is_zero() && (b % g).is_zero() && BigInt::gcd(a / g, b / g) == 1, "gcd", a, b);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t iterations = 100000;
+    uint64_t seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        } else if (argv[i][0] != '-') {
+            iterations = std::strtoull(argv[i], nullptr, 10);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [iterations] [--seed N] [--threads N]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Fuzzing BigInt: " << iterations << " iterations on " << threads
+              << " threads, seed " << seed << std::endl;
+    auto start = std::chrono::steady_clock::now();
+
+    // Thread t runs iterations t, t + threads, ... with its own generator, so a failing seed
+    // reproduces with the same thread count.
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([=] {
+            std::mt19937_64 gen(seed + 0x9E3779B97F4A7C15ULL * t);
+            for (uint64_t i = t; i < iterations && failures.load() == 0; i += threads) {
+                fuzz_once(gen, i);
+            }
+        }));
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << checks.load() << " checks in " << elapsed.count() << " s" << std::endl;
+    if (failures.load() != 0) {
+        std::cerr << failures.load() << " checks failed (seed " << seed << ", " << threads << " threads)" << std::endl;
+        return 1;
+    }
+    std::cout << "All BigInt fuzz checks passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "bigint_io.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "bigint_io assumes a little-endian host; records are stored as native limbs."
+#endif
+
+namespace {
+
+const char MAGIC[4] = {'B', 'I', 'G', 'S'};
+const uint16_t FORMAT_VERSION = 1;
+const size_t HEADER_SIZE = 32;
+const size_t COUNT_OFFSET = 16;
+const uint64_t MAX_RECORD_LIMBS = 1 << 20; // cap when the header gives no bit size (64 Mbit)
+
+void encode_header(const BigIntStreamHeader& h, unsigned char* out) {
+    uint32_t reserved = 0;
+    std::memcpy(out, MAGIC, 4);
+    std::memcpy(out + 4, &h.version, 2);
+    std::memcpy(out + 6, &h.generator, 2);
+    std::memcpy(out + 8, &h.bit_size, 4);
+    std::memcpy(out + 12, &reserved, 4);
+    std::memcpy(out + 16, &h.count, 8);
+    std::memcpy(out + 24, &h.seed, 8);
+}
+
+BigIntStreamHeader decode_header(const unsigned char* in) {
+    if (std::memcmp(in, MAGIC, 4) != 0) {
+        throw std::runtime_error("Not a BigInt stream (bad magic).");
+    }
+    BigIntStreamHeader h;
+    std::memcpy(&h.version, in + 4, 2);
+    std::memcpy(&h.generator, in + 6, 2);
+    std::memcpy(&h.bit_size, in + 8, 4);
+    std::memcpy(&h.count, in + 16, 8);
+    std::memcpy(&h.seed, in + 24, 8);
+    if (h.version != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported BigInt stream version.");
+    }
+    return h;
+}
+
+/**
+ * @brief Rejects a record limb count that cannot come from a stream with this header, so a
+ *        corrupt count is reported before it sizes a buffer or a read.
+ */
+void check_limb_count(const BigIntStreamHeader& h, uint64_t n) {
+    uint64_t limit = h.bit_size > 0 ? (uint64_t(h.bit_size) + 63) / 64 : MAX_RECORD_LIMBS;
+    if (n > limit) {
+        throw std::runtime_error("Corrupt BigInt stream record (limb count too large).");
+    }
+}
+
+} // namespace
+
+BigIntStreamHeader::BigIntStreamHeader(uint32_t bit_size, uint16_t generator, uint64_t seed)
+    : version(FORMAT_VERSION), generator(generator), bit_size(bit_size), count(BIGINT_COUNT_UNKNOWN), seed(seed) {}
+
+/**
+ * @brief Writes the header and prepares the record buffer.
+ *
+ * @param out Destination stream; should be opened in binary mode.
+ * @param header Stream metadata. Its count is written as given and corrected on finish() if
+ *        possible.
+ * @param buffer_size Bytes accumulated before each write to `out`.
+ */
+BigIntWriter::BigIntWriter(std::ostream& out, const BigIntStreamHeader& header, size_t buffer_size)
+    : out(out), buffer(std::max<size_t>(buffer_size, HEADER_SIZE)), fill(0), count(0),
+      start(out.tellp()), header_count(header.count), finished(false) {
+    unsigned char raw[HEADER_SIZE];
+    encode_header(header, raw);
+    put(raw, HEADER_SIZE);
+}
+
+BigIntWriter::~BigIntWriter() {
+    try {
+        finish();
+    } catch (...) {
+        // Destructors must not throw; call finish() explicitly to see write errors.
+    }
+}
+
+void BigIntWriter::put(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        if (fill == buffer.size()) flush();
+        size_t chunk = std::min(size, buffer.size() - fill);
+        std::memcpy(&buffer[fill], bytes, chunk);
+        fill += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+}
+
+void BigIntWriter::write_limbs(const uint64_t* limbs, size_t limb_count) {
+    uint64_t n = limb_count;
+    put(&n, sizeof(n));
+    put(limbs, limb_count * sizeof(uint64_t));
+    ++count;
+}
+
+/**
+ * @brief Appends one record holding the significant limbs of `value`.
+ */
+void BigIntWriter::write(const BigInt& value) {
+    write_limbs(value.limb_data(), value.limb_count());
+}
+
+/**
+ * @brief Appends records that were already encoded with encode_record, e.g. by worker threads.
+ *
+ * @param data Concatenated encoded records.
+ * @param size Length of `data` in bytes.
+ * @param records Number of records contained in `data`.
+ */
+void BigIntWriter::write_encoded(const char* data, size_t size, uint64_t records) {
+    if (size >= buffer.size()) {
+        flush();
+        out.write(data, size);
+    } else {
+        put(data, size);
+    }
+    count += records;
+}
+
+size_t BigIntWriter::record_size(const BigInt& value) {
+    return (1 + value.limb_count()) * sizeof(uint64_t);
+}
+
+/**
+ * @brief Encodes one record into `out`, which must have room for record_size(value) bytes.
+ * @return The number of bytes written.
+ */
+size_t BigIntWriter::encode_record(const BigInt& value, char* out) {
+    uint64_t n = value.limb_count();
+    std::memcpy(out, &n, sizeof(n));
+    std::memcpy(out + sizeof(n), value.limb_data(), n * sizeof(uint64_t));
+    return (1 + n) * sizeof(uint64_t);
+}
+
+void BigIntWriter::flush() {
+    if (fill > 0) {
+        out.write(buffer.data(), fill);
+        fill = 0;
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write BigInt stream.");
+    }
+}
+
+/**
+ * @brief Flushes pending records and, on seekable streams, records the final count if it
+ *        differs from the header's (e.g. a counted run that was interrupted).
+ */
+void BigIntWriter::finish() {
+    if (finished) return;
+    finished = true;
+    flush();
+    if (count != header_count && start != std::streampos(-1)) {
+        std::streampos end = out.tellp();
+        out.seekp(start + std::streamoff(COUNT_OFFSET));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.seekp(end);
+    }
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Failed to write BigInt stream.");
+    }
+}
+
+BigIntReader::BigIntReader(std::istream& in) : in(in) {
+    unsigned char raw[HEADER_SIZE];
+    if (!in.read(reinterpret_cast<char*>(raw), HEADER_SIZE)) {
+        throw std::runtime_error("Truncated BigInt stream header.");
+    }
+    hdr = decode_header(raw);
+    remaining = hdr.count;
+}
+
+/**
+ * @brief Reads the next record into `value`.
+ * @return false at the end of the stream.
+ */
+bool BigIntReader::read(BigInt& value) {
+    if (remaining == 0) return false;
+    uint64_t n;
+    if (!in.read(reinterpret_cast<char*>(&n), sizeof(n))) {
+        if (hdr.count == BIGINT_COUNT_UNKNOWN && in.gcount() == 0) return false;
+        throw std::runtime_error("Truncated BigInt stream record.");
+    }
+    check_limb_count(hdr, n);
+    if (scratch.size() < n) scratch.resize(n);
+    if (!in.read(reinterpret_cast<char*>(scratch.data()), n * sizeof(uint64_t))) {
+        throw std::runtime_error("Truncated BigInt stream record.");
+    }
+    value.assign_limbs(scratch.data(), n);
+    if (remaining != BIGINT_COUNT_UNKNOWN) --remaining;
+    return true;
+}
+
+BigIntView::BigIntView(const void* data, size_t size) {
+    if (size < HEADER_SIZE) {
+        throw std::runtime_error("Truncated BigInt stream header.");
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) != 0) {
+        throw std::invalid_argument("BigInt stream memory must be 8-byte aligned.");
+    }
+    hdr = decode_header(static_cast<const unsigned char*>(data));
+    remaining = hdr.count;
+    cursor = static_cast<const uint64_t*>(data) + HEADER_SIZE / sizeof(uint64_t);
+    end = static_cast<const uint64_t*>(data) + size / sizeof(uint64_t);
+}
+
+/**
+ * @brief Points `limbs` at the next record's limbs inside the mapped memory.
+ * @return false at the end of the data.
+ */
+bool BigIntView::next(const uint64_t*& limbs, size_t& count) {
+    if (remaining == 0 || cursor == end) return false;
+    uint64_t n = *cursor;
+    check_limb_count(hdr, n);
+    if (n > size_t(end - cursor - 1)) {
+        throw std::runtime_error("Truncated BigInt stream record.");
+    }
+    limbs = cursor + 1;
+    count = n;
+    cursor += 1 + n;
+    if (remaining != BIGINT_COUNT_UNKNOWN) --remaining;
+    return true;
+}
+
+bool BigIntView::next(BigInt& value) {
+    const uint64_t* limbs;
+    size_t count;
+    if (!next(limbs, count)) return false;
+    value.assign_limbs(limbs, count);
+    return true;
+}
+
+MappedBigIntFile::MappedBigIntFile(const std::string& path) : data(nullptr), size(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat " + path);
+    }
+    size = st.st_size;
+    if (size > 0) {
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED || size == 0) {
+        data = nullptr;
+        throw std::runtime_error("Cannot map " + path);
+    }
+}
+
+MappedBigIntFile::~MappedBigIntFile() {
+    if (data) munmap(data, size);
+}
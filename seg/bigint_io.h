@@ -0,0 +1,137 @@
+#ifndef BIGINT_IO_H
+#define BIGINT_IO_H
+
+#include "bigint.h"
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Binary stream format for sequences of BigInts. All integers are little-endian.
+ *
+ *   header (32 bytes)
+ *     0  char[4]  magic "BIGS"
+ *     4  uint16   format version (1)
+ *     6  uint16   generator id (BigIntGenerator)
+ *     8  uint32   nominal bit size of the numbers
+ *    12  uint32   reserved, zero
+ *    16  uint64   number of records, or BIGINT_COUNT_UNKNOWN
+ *    24  uint64   generator seed
+ *   records
+ *     uint64      limb count n
+ *     uint64[n]   limbs, least significant first
+ *
+ * Every field is 8-byte aligned, so a mapped file can be read in place.
+ */
+
+enum BigIntGenerator {
+    GENERATOR_UNKNOWN = 0,
+    GENERATOR_XORSHIFT = 1,
+    GENERATOR_CMWC = 2
+};
+
+const uint64_t BIGINT_COUNT_UNKNOWN = ~uint64_t(0);
+
+struct BigIntStreamHeader {
+    uint16_t version;
+    uint16_t generator;
+    uint32_t bit_size;
+    uint64_t count;
+    uint64_t seed;
+
+    BigIntStreamHeader(uint32_t bit_size = 0, uint16_t generator = GENERATOR_UNKNOWN, uint64_t seed = 0);
+};
+
+/**
+ * @brief Buffers records and hands them to the output stream in large writes.
+ *
+ * On finish() the header's record count is patched to the number actually written whenever
+ * the two differ and the stream is seekable; otherwise it stays as given
+ * (BIGINT_COUNT_UNKNOWN by default) and readers stop at end of file.
+ */
+class BigIntWriter {
+public:
+    BigIntWriter(std::ostream& out, const BigIntStreamHeader& header, size_t buffer_size = 1 << 16);
+    ~BigIntWriter();
+
+    void write(const BigInt& value);
+    void write_limbs(const uint64_t* limbs, size_t count);
+    void write_encoded(const char* data, size_t size, uint64_t records);
+    void flush();
+    void finish();
+
+    uint64_t written() const { return count; }
+
+    static size_t record_size(const BigInt& value);
+    static size_t encode_record(const BigInt& value, char* out);
+
+private:
+    void put(const void* data, size_t size);
+
+    std::ostream& out;
+    std::vector<char> buffer;
+    size_t fill;
+    uint64_t count;
+    std::streampos start;
+    uint64_t header_count;
+    bool finished;
+};
+
+/**
+ * @brief Reads records from an input stream into a caller-owned BigInt.
+ */
+class BigIntReader {
+public:
+    explicit BigIntReader(std::istream& in);
+
+    const BigIntStreamHeader& header() const { return hdr; }
+    bool read(BigInt& value);
+
+private:
+    std::istream& in;
+    BigIntStreamHeader hdr;
+    uint64_t remaining;
+    std::vector<uint64_t> scratch;
+};
+
+/**
+ * @brief Iterates over records held in memory (e.g. a mapped file) without copying limbs.
+ *
+ * The memory must stay valid and 8-byte aligned while the view is used.
+ */
+class BigIntView {
+public:
+    BigIntView(const void* data, size_t size);
+
+    const BigIntStreamHeader& header() const { return hdr; }
+    bool next(const uint64_t*& limbs, size_t& count);
+    bool next(BigInt& value);
+
+private:
+    const uint64_t* cursor;
+    const uint64_t* end;
+    BigIntStreamHeader hdr;
+    uint64_t remaining;
+};
+
+/**
+ * @brief Read-only memory mapping of a BigInt stream file.
+ */
+class MappedBigIntFile {
+public:
+    explicit MappedBigIntFile(const std::string& path);
+    ~MappedBigIntFile();
+
+    MappedBigIntFile(const MappedBigIntFile&) = delete;
+    MappedBigIntFile& operator=(const MappedBigIntFile&) = delete;
+
+    BigIntView view() const { return BigIntView(data, size); }
+
+private:
+    void* data;
+    size_t size;
+};
+
+#endif // BIGINT_IO_H
@@ -1,6 +1,15 @@
 #include <iostream>
 #include <cassert>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <random>
 #include "bigint.h"
+#include "bigint_io.h"
+#include "batch-powmod.h"
+#include "multi-exp.h"
 
 void test_arithmetic_operators() {
     std::cout << "Running arithmetic operator tests..." << std::endl;
@@ -94,10 +103,351 @@ void test_bitwise_operators() {
     std::cout << "Bitwise operator tests passed!" << std::endl;
 }
 
+void test_bit_primitives() {
+    std::cout << "Running bit primitive tests..." << std::endl;
+
+    BigInt zero(static_cast<uint64_t>(0));
+    assert(zero.bit_length() == 0);
+    assert(zero.count_trailing_zeros() == 0);
+    assert(zero.is_zero());
+
+    BigInt a(static_cast<uint64_t>(0b101000)); // 40
+    assert(a.bit_length() == 6);
+    assert(a.count_trailing_zeros() == 3);
+
+    // Shifts across limb boundaries must grow the value and keep it normalized.
+    BigInt b(static_cast<uint64_t>(1));
+    b <<= 130;
+    assert(b.bit_length() == 131);
+    assert(b.count_trailing_zeros() == 130);
+    assert(b.get_bit(130));
+    b >>= 128;
+    assert(b == BigInt(static_cast<uint64_t>(4)));
+
+    // A wide zero with spare limbs compares equal to a one-limb zero.
+    BigInt wide(static_cast<unsigned int>(256));
+    assert(wide == zero);
+    assert(!(wide < zero) && !(zero < wide));
+
+    // Multi-limb division: (2^200 + 12345) / (2^70 + 3)
+    BigInt num(static_cast<uint64_t>(1));
+    num <<= 200;
+    num = num + BigInt(static_cast<uint64_t>(12345));
+    BigInt den(static_cast<uint64_t>(1));
+    den <<= 70;
+    den = den + BigInt(static_cast<uint64_t>(3));
+    BigInt q = num / den;
+    BigInt r = num % den;
+    assert(r < den);
+    assert(q * den + r == num);
+
+    std::cout << "Bit primitive tests passed!" << std::endl;
+}
+
+void test_string_conversion() {
+    std::cout << "Running string conversion tests..." << std::endl;
+
+    // Hex strings whose length is not a multiple of 16 digits.
+    BigInt a(std::string("0x123456789abcdef01"));
+    assert(a.to_hex_string() == "0x123456789abcdef01");
+    BigInt b(std::string("fff"));
+    assert(b == BigInt(static_cast<uint64_t>(0xfff)));
+
+    // 2^64 crosses the single-limb boundary in every base.
+    BigInt c(static_cast<uint64_t>(1));
+    c <<= 64;
+    assert(c.to_decimal_string() == "18446744073709551616");
+    std::string dec = "18446744073709551616";
+    assert(BigInt::from_decimal(dec.data(), dec.size()) == c);
+    std::string bin = c.to_binary_string();
+    assert(bin.size() == 65);
+    assert(BigInt::from_binary(bin.data(), bin.size()) == c);
+
+    assert(BigInt(static_cast<uint64_t>(0)).to_decimal_string() == "0");
+    assert(BigInt(static_cast<uint64_t>(0)).to_hex_string() == "0x0");
+
+    // 10^600 - 1 is long enough to take the divide-and-conquer path both ways.
+    std::string nines(600, '9');
+    BigInt d = BigInt::from_decimal(nines.data(), nines.size());
+    assert(d.to_decimal_string() == nines);
+    BigInt e = d + BigInt(static_cast<uint64_t>(1));
+    assert(e.to_decimal_string() == "1" + std::string(600, '0'));
+
+    // Caller-provided buffers.
+    char buffer[32];
+    size_t n = BigInt(static_cast<uint64_t>(255)).write_hex(buffer, sizeof(buffer));
+    assert(std::string(buffer, n) == "ff");
+    n = BigInt(static_cast<uint64_t>(1234567)).write_decimal(buffer, sizeof(buffer));
+    assert(std::string(buffer, n) == "1234567");
+
+    std::cout << "String conversion tests passed!" << std::endl;
+}
+
+void test_stream_format() {
+    std::cout << "Running binary stream format tests..." << std::endl;
+
+    BigInt big(static_cast<uint64_t>(1));
+    big <<= 300;
+    big = big + BigInt(static_cast<uint64_t>(99));
+    std::vector<BigInt> values = {
+        BigInt(static_cast<uint64_t>(0)),
+        BigInt(static_cast<uint64_t>(42)),
+        big
+    };
+
+    // Seekable stream: the writer patches the record count into the header.
+    std::stringstream buffer(std::ios::in | std::ios::out | std::ios::binary);
+    {
+        BigIntWriter writer(buffer, BigIntStreamHeader(512, GENERATOR_CMWC, 1234), 64);
+        for (const auto& v : values) {
+            writer.write(v);
+        }
+        writer.finish();
+    }
+
+    BigIntReader reader(buffer);
+    assert(reader.header().bit_size == 512);
+    assert(reader.header().generator == GENERATOR_CMWC);
+    assert(reader.header().seed == 1234);
+    assert(reader.header().count == values.size());
+    BigInt value(static_cast<uint64_t>(0));
+    for (const auto& v : values) {
+        assert(reader.read(value));
+        assert(value == v);
+    }
+    assert(!reader.read(value));
+
+    // Zero-copy reading of the same bytes from a mapped file.
+    const char* path = "bigint_test_stream.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << buffer.str();
+    }
+    {
+        MappedBigIntFile mapped(path);
+        BigIntView view = mapped.view();
+        const uint64_t* limbs;
+        size_t count;
+        size_t i = 0;
+        while (view.next(limbs, count)) {
+            value.assign_limbs(limbs, count);
+            assert(value == values[i++]);
+        }
+        assert(i == values.size());
+    }
+    std::remove(path);
+
+    // A header that promised more records than were written is corrected on finish().
+    std::stringstream short_run(std::ios::in | std::ios::out | std::ios::binary);
+    {
+        BigIntStreamHeader promised(512, GENERATOR_CMWC, 1234);
+        promised.count = 10;
+        BigIntWriter writer(short_run, promised);
+        writer.write(values[1]);
+        writer.finish();
+    }
+    BigIntReader short_reader(short_run);
+    assert(short_reader.header().count == 1);
+    assert(short_reader.read(value) && value == values[1]);
+    assert(!short_reader.read(value));
+
+    // A corrupt limb count is rejected before it sizes a buffer: one limb more than the
+    // header's bit size allows, and a count that would overflow n * sizeof(uint64_t).
+    std::string bytes = buffer.str();
+    const size_t first_record = 32;
+    for (uint64_t corrupt : {uint64_t(9), ~uint64_t(0) / 4}) {
+        std::string damaged = bytes;
+        std::memcpy(&damaged[first_record], &corrupt, sizeof(corrupt));
+        std::stringstream in(damaged, std::ios::in | std::ios::binary);
+        BigIntReader bad_reader(in);
+        bool rejected = false;
+        try {
+            bad_reader.read(value);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        assert(rejected);
+
+        std::vector<uint64_t> aligned(damaged.size() / sizeof(uint64_t));
+        std::memcpy(aligned.data(), damaged.data(), aligned.size() * sizeof(uint64_t));
+        BigIntView bad_view(aligned.data(), aligned.size() * sizeof(uint64_t));
+        rejected = false;
+        try {
+            bad_view.next(value);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        assert(rejected);
+    }
+
+    std::cout << "Binary stream format tests passed!" << std::endl;
+}
+
+BigInt random_bigint(std::mt19937_64& gen, size_t bits) {
+    std::vector<uint64_t> words((bits + 63) / 64);
+    for (auto& w : words) {
+        w = gen();
+    }
+    if (bits % 64 != 0) {
+        words.back() &= (uint64_t(1) << (bits % 64)) - 1;
+    }
+    BigInt value(uint64_t(0));
+    value.assign_limbs(words.data(), words.size());
+    return value;
+}
+
+void test_batch_modular_pow() {
+    std::cout << "Running batch modular_pow tests (" << powmod_kernel_name(POWMOD_KERNEL_AUTO) << " selected)..." << std::endl;
+    std::mt19937_64 gen(20240611);
+    std::vector<PowmodKernel> kernels = {POWMOD_KERNEL_SCALAR};
+    if (powmod_avx2_available()) {
+        kernels.push_back(POWMOD_KERNEL_AVX2);
+    }
+
+    // Mixed widths within a batch, partial lane groups, and exponent/base edge cases.
+    std::vector<size_t> widths = {2, 31, 32, 33, 64, 65, 96, 128, 255, 521, 1024};
+    for (size_t count = 1; count <= 9; ++count) {
+        std::vector<BigInt> bases, exponents, moduli;
+        for (size_t i = 0; i < count; ++i) {
+            size_t bits = widths[(count * 7 + i) % widths.size()];
+            BigInt modulus = random_bigint(gen, bits);
+            modulus.set_bit(0, true);
+            modulus.set_bit(bits - 1, true);
+            moduli.push_back(modulus);
+            bases.push_back(random_bigint(gen, bits + 70));
+            exponents.push_back(random_bigint(gen, 1 + gen() % 300));
+        }
+        moduli[0] = BigInt(uint64_t(count % 2 == 0 ? 1 : 3));
+        bases[count - 1] = moduli[count - 1] - BigInt(uint64_t(1));
+        if (count > 2) {
+            exponents[1] = BigInt(uint64_t(0));
+            bases[2] = BigInt(uint64_t(0));
+        }
+
+        for (PowmodKernel kernel : kernels) {
+            std::vector<BigInt> results = batch_modular_pow(bases, exponents, moduli, kernel);
+            assert(results.size() == count);
+            for (size_t i = 0; i < count; ++i) {
+                assert(results[i] == BigInt::modular_pow(bases[i], exponents[i], moduli[i]));
+            }
+        }
+    }
+
+    bool rejected = false;
+    try {
+        batch_modular_pow({BigInt(uint64_t(3))}, {BigInt(uint64_t(5))}, {BigInt(uint64_t(10))});
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    assert(rejected);
+    std::cout << "Batch modular_pow tests passed!" << std::endl;
+}
+
+void test_fused_operations() {
+    std::cout << "Running fused modular operation tests..." << std::endl;
+    std::mt19937_64 gen(987654321);
+
+    std::vector<size_t> widths = {1, 63, 64, 65, 128, 130, 512, 1000, 2048};
+    for (size_t modulus_bits : widths) {
+        for (int trial = 0; trial < 20; ++trial) {
+            BigInt modulus = random_bigint(gen, modulus_bits);
+            modulus.set_bit(modulus_bits - 1, true);
+            BigInt a = random_bigint(gen, modulus_bits + gen() % 70);
+            BigInt b = random_bigint(gen, 1 + gen() % (modulus_bits + 64));
+            if (trial == 0) a = BigInt(uint64_t(0));
+
+            assert(BigInt::mulmod(a, b, modulus) == (a * b) % modulus);
+            assert(BigInt::sqrmod(a, modulus) == (a * a) % modulus);
+            assert(BigInt::sqrmod(b, modulus) == BigInt::mulmod(b, b, modulus));
+
+            BigInt x = a % modulus;
+            BigInt y = b % modulus;
+            assert(BigInt::addmod(x, y, modulus) == (x + y) % modulus);
+            assert(BigInt::submod(x, y, modulus) == (x + modulus - y) % modulus);
+            assert(BigInt::addmod(BigInt::submod(x, y, modulus), y, modulus) == x);
+        }
+    }
+
+    // Squares whose cross terms carry through every limb.
+    std::vector<uint64_t> ones(8, ~0ULL);
+    BigInt all_ones(uint64_t(0));
+    all_ones.assign_limbs(ones.data(), ones.size());
+    BigInt big_modulus = all_ones * all_ones + BigInt(uint64_t(1));
+    assert(BigInt::sqrmod(all_ones, big_modulus) == all_ones * all_ones);
+
+    bool threw = false;
+    try {
+        BigInt::mulmod(all_ones, all_ones, BigInt(uint64_t(0)));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Comparisons against a single limb, including multi-limb values and zero.
+    BigInt zero(uint64_t(0));
+    BigInt five(uint64_t(5));
+    assert(zero == 0 && zero < 1 && zero <= 0 && !(zero > 0));
+    assert(five == 5 && five != 4 && five > 4 && five >= 5 && five < 6 && five <= 5);
+    assert(all_ones > ~0ULL && all_ones != 0 && !(all_ones <= 5));
+    std::cout << "Fused modular operation tests passed!" << std::endl;
+}
+
+void test_multi_exponentiation() {
+    std::cout << "Running fixed-base and multi-exponentiation tests..." << std::endl;
+    std::mt19937_64 gen(424242);
+
+    for (size_t modulus_bits : {2, 64, 65, 200, 521}) {
+        BigInt modulus = random_bigint(gen, modulus_bits);
+        modulus.set_bit(modulus_bits - 1, true);
+        BigInt base = random_bigint(gen, modulus_bits + 10);
+
+        for (unsigned int teeth : {1u, 3u, 6u}) {
+            FixedBaseTable comb(base, modulus, 300, teeth);
+            assert(comb.max_exponent_bits() >= 300);
+            assert(comb.table_size() == size_t(1) << teeth);
+            for (size_t exponent_bits : {0, 1, 63, 64, 150, 300}) {
+                BigInt exponent = random_bigint(gen, std::max<size_t>(exponent_bits, 1));
+                if (exponent_bits == 0) exponent = BigInt(uint64_t(0));
+                if (exponent_bits > 0) exponent.set_bit(exponent_bits - 1, true);
+                assert(comb.pow(exponent) == BigInt::modular_pow(base, exponent, modulus));
+            }
+        }
+
+        for (size_t count = 1; count <= 3; ++count) {
+            std::vector<BigInt> bases, exponents;
+            BigInt expected = BigInt(uint64_t(1)) % modulus;
+            for (size_t i = 0; i < count; ++i) {
+                bases.push_back(random_bigint(gen, modulus_bits + 5));
+                exponents.push_back(random_bigint(gen, 1 + gen() % 400));
+                expected = BigInt::mulmod(expected, BigInt::modular_pow(bases[i], exponents[i], modulus), modulus);
+            }
+            assert(multi_modular_pow(bases, exponents, modulus) == expected);
+        }
+    }
+
+    FixedBaseTable small(BigInt(uint64_t(3)), BigInt(uint64_t(1000003)), 64);
+    BigInt too_long(uint64_t(1));
+    too_long <<= small.max_exponent_bits();
+    bool rejected = false;
+    try {
+        small.pow(too_long);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    assert(rejected);
+    std::cout << "Fixed-base and multi-exponentiation tests passed!" << std::endl;
+}
+
 int main() {
     test_arithmetic_operators();
     test_comparison_operators();
     test_bitwise_operators();
+    test_bit_primitives();
+    test_string_conversion();
+    test_stream_format();
+    test_batch_modular_pow();
+    test_fused_operations();
+    test_multi_exponentiation();
 
     std::cout << "All BigInt tests passed!" << std::endl;
 
@@ -0,0 +1,103 @@
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include <ctime>
+#include <chrono>
+#include <algorithm>
+#include "bigint.h"
+#include "cmwc.h"
+
+/**
+ * @brief Constructs a CMWC generator and seeds it.
+ *
+ * The state array Q is seeded using a simple Linear Congruential Generator (LCG).
+ * The initial carry `c` is also generated and must be less than the multiplier `A`.
+ *
+ * @param seed The seed value for initialization.
+ */
+CMWC::CMWC(uint64_t seed) : Q(R), c(0), i(R - 1) {
+    uint64_t x = seed;
+    for (uint32_t j = 0; j < R; ++j) {
+        x = 6364136223846793005ULL * x + 1;
+        Q[j] = x;
+    }
+    x = 6364136223846793005ULL * x + 1;
+    c = x % A;
+}
+
+/**
+ * @brief Generates the next 64-bit pseudo-random number using the CMWC algorithm.
+ *
+ * This method updates the generator's state and returns a new pseudo-random number.
+ * The lag `R` must be a power of two for the index update `(i + 1) & (R - 1)` to work correctly.
+ *
+ * @return A 64-bit pseudo-random number.
+ */
+uint64_t CMWC::next() {
+    i = (i + 1) & (R - 1);
+    unsigned __int128 t = A * Q[i] + c;
+    c = t >> 64;
+    uint64_t x = t;
+    Q[i] = x;
+    return 0xFFFFFFFFFFFFFFFF - x;
+}
+
+const std::vector<int> supported_bits = {40, 56, 80, 128, 168, 224, 256, 512, 1024, 2048, 4096};
+
+/**
+ * @brief Checks if a given bit size is supported.
+ * @param bits The bit size to check.
+ * @return True if the bit size is supported, false otherwise.
+ */
+bool is_supported(int bits) {
+    return std::find(supported_bits.begin(), supported_bits.end(), bits) != supported_bits.end();
+}
+
+/**
+ * @brief Generates a pseudo-random large integer using the CMWC algorithm.
+ *
+ * @param bits The desired number of bits for the random number. Must be one of the supported sizes.
+ * @param duration Reference to a duration object to store the generation time.
+ * @return A BigInt representing the generated pseudo-random number.
+ */
+BigInt generate_random_cmwc(int bits, std::chrono::duration<double, std::milli> &duration) {
+    if (!is_supported(bits)) {
+        throw std::invalid_argument("Invalid bit size selected.");
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    CMWC cmwc(time(0));
+    BigInt result = generate_random_cmwc(bits, cmwc);
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    duration = end - start;
+
+    return result;
+}
+
+/**
+ * @brief Generates a pseudo-random large integer from an existing CMWC state.
+ *
+ * Unlike the timed overload, the generator is not reseeded, so consecutive calls
+ * keep advancing the same stream. This is the form used by long-running producers.
+ *
+ * @param bits The desired number of bits for the random number. Must be one of the supported sizes.
+ * @param cmwc The generator to draw limbs from.
+ * @return A BigInt representing the generated pseudo-random number.
+ */
+BigInt generate_random_cmwc(int bits, CMWC& cmwc) {
+    if (!is_supported(bits)) {
+        throw std::invalid_argument("Invalid bit size selected.");
+    }
+
+    BigInt result(static_cast<unsigned int>(bits));
+    size_t num_limbs = (bits + 63) / 64;
+    std::vector<uint64_t> limbs(num_limbs);
+    for (size_t i = 0; i < num_limbs; ++i) {
+        limbs[i] = cmwc.next();
+    }
+    result.set_limbs(limbs);
+    return result;
+}
@@ -0,0 +1,39 @@
+#ifndef CMWC_H
+#define CMWC_H
+
+#include "bigint.h"
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+class CMWC {
+public:
+    /**
+     * @brief Constructs a CMWC generator and seeds it.
+     * @param seed The seed value for initialization.
+     */
+    CMWC(uint64_t seed);
+
+    /**
+     * @brief Generates the next 64-bit pseudo-random number.
+     * @return A 64-bit pseudo-random number.
+     */
+    uint64_t next();
+
+private:
+    static const uint32_t R = 256;
+    static const uint64_t A = 1234567890123456789ULL;
+
+    std::vector<uint64_t> Q;
+    uint64_t c;
+    uint32_t i;
+};
+
+extern const std::vector<int> supported_bits;
+
+bool is_supported(int bits);
+
+BigInt generate_random_cmwc(int bits, std::chrono::duration<double, std::milli>& duration);
+BigInt generate_random_cmwc(int bits, CMWC& cmwc);
+
+#endif // CMWC_H
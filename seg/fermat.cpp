@@ -3,6 +3,7 @@
 #include <iostream> // Added for main function
 #include <cstdlib>  // Added for std::atoi
 #include "fermat.h"
+#include "batch-powmod.h"
 
 /**
  * @brief Performs the Fermat primality test on a BigInt.
@@ -12,20 +13,72 @@
  * @return true if n is likely prime, false otherwise.
  */
 bool is_prime_fermat(const BigInt& n, int k) {
-    if (n <= BigInt(uint64_t(1)) || n == BigInt(uint64_t(4))) return false;
-    if (n <= BigInt(uint64_t(3))) return true;
+    if (n <= 1 || n == 4) return false;
+    if (n <= 3) return true;
     if (n.is_even()) return false;
 
     std::random_device rd;
     std::mt19937_64 gen(rd());
     std::uniform_int_distribution<uint64_t> dis;
 
+    const BigInt one(uint64_t(1));
+    const BigInt n_minus_1 = n - one;
+    const BigInt n_minus_3 = n - BigInt(uint64_t(3));
+
     for (int i = 0; i < k; i++) {
-        BigInt a = BigInt(dis(gen)) % (n - BigInt(uint64_t(3))) + BigInt(uint64_t(2));
-        if (BigInt::modular_pow(a, n - BigInt(uint64_t(1)), n) != BigInt(uint64_t(1))) {
+        BigInt a = BigInt(dis(gen)) % n_minus_3 + BigInt(uint64_t(2));
+        if (BigInt::modular_pow(a, n_minus_1, n) != one) {
             return false;
         }
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Fermat-tests many candidates at once, running each round through batch_modular_pow.
+ *
+ * Candidates that fail a round drop out of the later ones.
+ *
+ * @param candidates The numbers to test.
+ * @param k The number of rounds of testing to perform.
+ * @return One flag per candidate: true if it is likely prime.
+ */
+std::vector<bool> is_prime_fermat_batch(const std::vector<BigInt>& candidates, int k) {
+    std::vector<bool> result(candidates.size(), false);
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const BigInt& n = candidates[i];
+        if (n <= 3 || n.is_even()) {
+            result[i] = is_prime_fermat(n, k);
+        } else {
+            pending.push_back(i);
+        }
+    }
+
+    std::random_device rd;
+    std::mt19937_64 gen(rd());
+    std::uniform_int_distribution<uint64_t> dis;
+    const BigInt one(uint64_t(1));
+
+    for (int round = 0; round < k && !pending.empty(); ++round) {
+        std::vector<BigInt> bases, exponents, moduli;
+        for (size_t i : pending) {
+            const BigInt& n = candidates[i];
+            bases.push_back(BigInt(dis(gen)) % (n - BigInt(uint64_t(3))) + BigInt(uint64_t(2)));
+            exponents.push_back(n - one);
+            moduli.push_back(n);
+        }
+        std::vector<BigInt> powers = batch_modular_pow(bases, exponents, moduli);
+        std::vector<size_t> survivors;
+        for (size_t j = 0; j < pending.size(); ++j) {
+            if (powers[j] == one) survivors.push_back(pending[j]);
+        }
+        pending.swap(survivors);
+    }
+
+    for (size_t i : pending) {
+        result[i] = true;
+    }
+    return result;
+}
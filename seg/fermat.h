@@ -1,8 +1,10 @@
 #ifndef FERMAT_H
 #define FERMAT_H
 
+#include <vector>
 #include "bigint.h"
 
 bool is_prime_fermat(const BigInt& n, int k);
+std::vector<bool> is_prime_fermat_batch(const std::vector<BigInt>& candidates, int k);
 
 #endif // FERMAT_H
@@ -2,6 +2,7 @@
 #include <vector>
 #include <random>
 #include "miller-rabin.h"
+#include "batch-powmod.h"
 
 /**
  * @brief Performs the Miller-Rabin primality test on a BigInt.
@@ -11,34 +12,36 @@
  * @return true if n is likely prime, false otherwise.
  */
 bool is_prime_miller_rabin(const BigInt& n, int k) {
-    if (n <= BigInt(uint64_t(1)) || n == BigInt(uint64_t(4))) return false;
-    if (n <= BigInt(uint64_t(3))) return true;
+    if (n <= 1 || n == 4) return false;
+    if (n <= 3) return true;
     if (n.is_even()) return false;
 
-    BigInt d = n - BigInt(uint64_t(1));
-    while (d.is_even()) {
-        d >>= 1;
-    }
+    const BigInt one(uint64_t(1));
+    const BigInt n_minus_1 = n - one;
+    const BigInt n_minus_3 = n - BigInt(uint64_t(3));
+
+    // n - 1 = 2^s * d with d odd, stripped in a single shift.
+    size_t s = n_minus_1.count_trailing_zeros();
+    BigInt d = n_minus_1;
+    d >>= s;
 
     std::random_device rd;
     std::mt19937_64 gen(rd());
     std::uniform_int_distribution<uint64_t> dis;
 
     for (int i = 0; i < k; i++) {
-        BigInt a = BigInt(dis(gen)) % (n - BigInt(uint64_t(3))) + BigInt(uint64_t(2));
+        BigInt a = BigInt(dis(gen)) % n_minus_3 + BigInt(uint64_t(2));
         BigInt x = BigInt::modular_pow(a, d, n);
 
-        if (x == BigInt(uint64_t(1)) || x == n - BigInt(uint64_t(1))) {
+        if (x == one || x == n_minus_1) {
             continue;
         }
 
-        BigInt d_temp = d;
         bool prime = false;
-        while (d_temp != n - BigInt(uint64_t(1))) {
-            x = (x * x) % n;
-            d_temp <<= 1;
-            if (x == BigInt(uint64_t(1))) return false;
-            if (x == n - BigInt(uint64_t(1))) {
+        for (size_t r = 1; r < s; ++r) {
+            x = BigInt::sqrmod(x, n);
+            if (x == one) return false;
+            if (x == n_minus_1) {
                 prime = true;
                 break;
             }
@@ -48,3 +51,114 @@ bool is_prime_miller_rabin(const BigInt& n, int k) {
 
     return true;
 }
+
+/**
+ * @brief Strong probable-prime test to base 2: a single Miller-Rabin round with a = 2.
+ *
+ * 2^d mod n is computed left to right, and with base 2 the "multiply by the base" step for a
+ * set exponent bit is a one-bit left shift followed by at most one subtraction of n, so only
+ * the squarings pay for a full multiply and reduction. Every prime passes; composites that
+ * pass (2047, 3277, ...) are rare enough that this is the cheapest useful first screen.
+ *
+ * @param n The BigInt to test.
+ * @return true if n is prime or a strong pseudoprime to base 2, false if n is composite.
+ */
+bool is_sprp_base2(const BigInt& n) {
+    if (n <= 3) return n >= 2;
+    if (n.is_even()) return false;
+
+    const BigInt one(uint64_t(1));
+    const BigInt n_minus_1 = n - one;
+    size_t s = n_minus_1.count_trailing_zeros();
+    BigInt d = n_minus_1;
+    d >>= s;
+
+    // The top bit of d is set, so the first square-and-double of 1 leaves 2.
+    BigInt x(uint64_t(2));
+    for (size_t i = d.bit_length() - 1; i-- > 0;) {
+        x = BigInt::sqrmod(x, n);
+        if (d.get_bit(i)) {
+            x <<= 1;
+            if (x >= n) {
+                x = x - n;
+            }
+        }
+    }
+
+    if (x == one || x == n_minus_1) return true;
+    for (size_t r = 1; r < s; ++r) {
+        x = BigInt::sqrmod(x, n);
+        if (x == n_minus_1) return true;
+        if (x == one) return false;
+    }
+    return false;
+}
+
+/**
+ * @brief Miller-Rabin over many candidates at once: each round computes every a^d mod n with
+ *        batch_modular_pow, then runs the short squaring chain per candidate.
+ *
+ * Candidates that fail a round drop out of the later ones.
+ *
+ * @param candidates The numbers to test.
+ * @param k The number of rounds of testing to perform.
+ * @return One flag per candidate: true if it is likely prime.
+ */
+std::vector<bool> is_prime_miller_rabin_batch(const std::vector<BigInt>& candidates, int k) {
+    std::vector<bool> result(candidates.size(), false);
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const BigInt& n = candidates[i];
+        if (n <= 3 || n.is_even()) {
+            result[i] = is_prime_miller_rabin(n, k);
+        } else {
+            pending.push_back(i);
+        }
+    }
+
+    const BigInt one(uint64_t(1));
+    std::vector<size_t> s(candidates.size(), 0);
+    std::vector<BigInt> d(candidates.size(), BigInt(uint64_t(0)));
+    for (size_t i : pending) {
+        BigInt n_minus_1 = candidates[i] - one;
+        s[i] = n_minus_1.count_trailing_zeros();
+        d[i] = n_minus_1;
+        d[i] >>= s[i];
+    }
+
+    std::random_device rd;
+    std::mt19937_64 gen(rd());
+    std::uniform_int_distribution<uint64_t> dis;
+
+    for (int round = 0; round < k && !pending.empty(); ++round) {
+        std::vector<BigInt> bases, exponents, moduli;
+        for (size_t i : pending) {
+            const BigInt& n = candidates[i];
+            bases.push_back(BigInt(dis(gen)) % (n - BigInt(uint64_t(3))) + BigInt(uint64_t(2)));
+            exponents.push_back(d[i]);
+            moduli.push_back(n);
+        }
+        std::vector<BigInt> powers = batch_modular_pow(bases, exponents, moduli);
+
+        std::vector<size_t> survivors;
+        for (size_t j = 0; j < pending.size(); ++j) {
+            size_t i = pending[j];
+            const BigInt& n = candidates[i];
+            const BigInt n_minus_1 = n - one;
+            BigInt x = powers[j];
+            bool prime = x == one || x == n_minus_1;
+            for (size_t r = 1; r < s[i] && !prime; ++r) {
+                x = BigInt::sqrmod(x, n);
+                if (x == one) break;
+                prime = x == n_minus_1;
+            }
+            if (prime) survivors.push_back(i);
+        }
+        pending.swap(survivors);
+    }
+
+    for (size_t i : pending) {
+        result[i] = true;
+    }
+    return result;
+}
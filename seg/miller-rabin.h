@@ -1,8 +1,11 @@
 #ifndef MILLER_RABIN_H
 #define MILLER_RABIN_H
 
+#include <vector>
 #include "bigint.h"
 
 bool is_prime_miller_rabin(const BigInt& n, int k);
+bool is_sprp_base2(const BigInt& n);
+std::vector<bool> is_prime_miller_rabin_batch(const std::vector<BigInt>& candidates, int k);
 
 #endif // MILLER_RABIN_H
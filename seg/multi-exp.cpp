@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <stdexcept>
+#include "multi-exp.h"
+
+/**
+ * @brief Precomputes the comb for `base` modulo `modulus`.
+ *
+ * The exponent is split into `teeth` rows of `spacing` = ceil(max_exponent_bits / teeth) bits;
+ * table[j] holds the product of base^(2^(i * spacing)) over the set bits i of j, so one column
+ * of exponent bits selects a single table entry. Building costs max_exponent_bits squarings
+ * plus 2^teeth multiplications.
+ *
+ * @param base The fixed base.
+ * @param modulus The modulus; must be non-zero.
+ * @param max_exponent_bits Longest exponent pow() will accept.
+ * @param teeth Comb teeth (rows); the table has 2^teeth entries. Between 1 and 16.
+ */
+FixedBaseTable::FixedBaseTable(const BigInt& base, const BigInt& modulus, size_t max_exponent_bits,
+                               unsigned int teeth)
+    : modulus(modulus), teeth(teeth), spacing(0) {
+    if (modulus.is_zero()) {
+        throw std::runtime_error("Division by zero.");
+    }
+    if (teeth == 0 || teeth > 16) {
+        throw std::invalid_argument("Comb teeth must be between 1 and 16.");
+    }
+    spacing = std::max<size_t>(1, (max_exponent_bits + teeth - 1) / teeth);
+
+    // Row bases: base^(2^(i * spacing)) for i = 0..teeth-1.
+    std::vector<BigInt> rows;
+    BigInt power = base % modulus;
+    for (unsigned int i = 0; i < teeth; ++i) {
+        rows.push_back(power);
+        for (size_t k = 0; k < spacing && i + 1 < teeth; ++k) {
+            power = BigInt::sqrmod(power, modulus);
+        }
+    }
+
+    table.assign(size_t(1) << teeth, BigInt(uint64_t(1)) % modulus);
+    for (size_t j = 1; j < table.size(); ++j) {
+        // Extend the entry without the top set bit of j by that bit's row base.
+        unsigned int top = 63 - __builtin_clzll(j);
+        table[j] = BigInt::mulmod(table[j ^ (size_t(1) << top)], rows[top], modulus);
+    }
+}
+
+/**
+ * @brief base^exponent mod modulus from the comb: one squaring and at most one table
+ *        multiplication per column.
+ *
+ * @param exponent Non-negative exponent of at most max_exponent_bits() bits.
+ */
+BigInt FixedBaseTable::pow(const BigInt& exponent) const {
+    if (exponent.bit_length() > spacing * teeth) {
+        throw std::invalid_argument("Exponent is longer than the comb table was built for.");
+    }
+    BigInt result = table[0];
+    for (size_t column = spacing; column-- > 0;) {
+        result = BigInt::sqrmod(result, modulus);
+        size_t j = 0;
+        for (unsigned int i = teeth; i-- > 0;) {
+            j = (j << 1) | (exponent.get_bit(i * spacing + column) ? 1 : 0);
+        }
+        if (j != 0) {
+            result = BigInt::mulmod(result, table[j], modulus);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Product of bases[i]^exponents[i] mod modulus by Straus's interleaved windows.
+ *
+ * Every base gets a table of its first 2^w powers; the exponents are then scanned together
+ * from the top, w bits at a time, so all bases share one chain of squarings and each adds
+ * one multiplication per non-zero window. For two bases (a^x * b^y, as in signature
+ * verification) that is about half the work of two modular_pow calls.
+ *
+ * @param bases The bases.
+ * @param exponents One non-negative exponent per base.
+ * @param modulus The modulus; must be non-zero.
+ */
+BigInt multi_modular_pow(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents,
+                         const BigInt& modulus) {
+    if (bases.empty() || bases.size() != exponents.size()) {
+        throw std::invalid_argument("multi_modular_pow needs one exponent per base.");
+    }
+    if (modulus.is_zero()) {
+        throw std::runtime_error("Division by zero.");
+    }
+
+    size_t exponent_bits = 0;
+    for (const auto& exponent : exponents) {
+        exponent_bits = std::max(exponent_bits, exponent.bit_length());
+    }
+    const unsigned int w = exponent_bits > 1024 ? 5 : 4;
+
+    const BigInt one = BigInt(uint64_t(1)) % modulus;
+    std::vector<std::vector<BigInt>> powers(bases.size());
+    for (size_t i = 0; i < bases.size(); ++i) {
+        BigInt base = bases[i] % modulus;
+        powers[i].push_back(one);
+        for (size_t d = 1; d < (size_t(1) << w); ++d) {
+            powers[i].push_back(BigInt::mulmod(powers[i].back(), base, modulus));
+        }
+    }
+
+    BigInt result = one;
+    size_t windows = (exponent_bits + w - 1) / w;
+    for (size_t window = windows; window-- > 0;) {
+        if (window + 1 != windows) {
+            for (unsigned int k = 0; k < w; ++k) {
+                result = BigInt::sqrmod(result, modulus);
+            }
+        }
+        for (size_t i = 0; i < bases.size(); ++i) {
+            size_t digit = 0;
+            for (unsigned int k = w; k-- > 0;) {
+                digit = (digit << 1) | (exponents[i].get_bit(window * w + k) ? 1 : 0);
+            }
+            if (digit != 0) {
+                result = BigInt::mulmod(result, powers[i][digit], modulus);
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,32 @@
+#ifndef MULTI_EXP_H
+#define MULTI_EXP_H
+
+#include <vector>
+#include "bigint.h"
+
+/**
+ * @brief Lim-Lee comb table for raising one fixed base to many exponents modulo one modulus.
+ *
+ * Built once per (base, modulus); each pow() then costs about max_exponent_bits / teeth
+ * squarings and as many multiplications, against roughly 1.5 * bits for modular_pow.
+ */
+class FixedBaseTable {
+public:
+    FixedBaseTable(const BigInt& base, const BigInt& modulus, size_t max_exponent_bits, unsigned int teeth = 6);
+
+    BigInt pow(const BigInt& exponent) const;
+
+    size_t max_exponent_bits() const { return spacing * teeth; }
+    size_t table_size() const { return table.size(); }
+
+private:
+    BigInt modulus;
+    unsigned int teeth;
+    size_t spacing;            // bits between neighbouring teeth of the comb
+    std::vector<BigInt> table; // table[j] = prod over set bits i of j of base^(2^(i * spacing))
+};
+
+BigInt multi_modular_pow(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents,
+                         const BigInt& modulus);
+
+#endif // MULTI_EXP_H
@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "prime-sieve.h"
+
+namespace {
+
+// Mod-30 wheel: byte k of a segment covers 30k + {1, 7, 11, 13, 17, 19, 23, 29}, one bit each.
+const uint64_t WHEEL = 30;
+const uint64_t WHEEL_RESIDUES[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+const int RESIDUE_BIT[30] = {
+    -1, 0, -1, -1, -1, -1, -1, 1, -1, -1, -1, 2, -1, 3, -1, -1,
+    -1, 4, -1, 5, -1, -1, -1, 6, -1, -1, -1, -1, -1, 7
+};
+
+const size_t SEGMENT_BYTES = 32 * 1024; // one L1 data cache worth of wheel bytes
+const size_t RUN_SEGMENTS = 16;         // consecutive segments a thread sieves per claim
+const uint64_t RUN_SPAN = RUN_SEGMENTS * SEGMENT_BYTES * WHEEL; // numbers covered by a full run
+// Sieving primes up to here are kept by every sieve; larger ones (needed above 2^40) are
+// generated by each thread once and carried in its LargePrimeBuckets.
+const uint64_t STORED_PRIME_LIMIT = 1 << 20;
+
+typedef std::vector<std::vector<std::pair<uint32_t, uint8_t>>> SegmentHits;
+
+class SegmentedSieve;
+
+/**
+ * @brief One thread's sieving primes above STORED_PRIME_LIMIT, each filed under the run that
+ *        holds its next odd multiple (a bucket sieve).
+ *
+ * A prime is generated once, when the thread's runs first reach p^2, and afterwards costs
+ * work only in runs it actually hits: once a run is struck the prime moves to the bucket of
+ * its next odd multiple, at most 2p numbers ahead, so a ring of 2 sqrt(high) / RUN_SPAN + 2
+ * buckets suffices. Runs must come in increasing order; primes waiting in runs the thread
+ * skips (sieved by other threads) jump ahead with one division each. Memory is one 8-byte
+ * entry per prime whose next multiple is still inside the range, so at most pi(sqrt(high)).
+ */
+class LargePrimeBuckets {
+public:
+    LargePrimeBuckets() : started(false), next_run(0), generated(STORED_PRIME_LIMIT) {}
+
+    void collect(const SegmentedSieve& sieve, uint64_t run, uint64_t run_bytes, uint64_t limit,
+                 SegmentHits& hits);
+
+private:
+    struct Entry {
+        uint32_t prime;
+        uint32_t offset; // from the start of the bucket's run
+    };
+
+    void file(const SegmentedSieve& sieve, uint64_t run, uint32_t prime, uint64_t offset);
+
+    bool started;
+    uint64_t next_run;  // first run neither sieved nor skipped yet
+    uint64_t generated; // every sieving prime up to here has been filed
+    std::vector<std::vector<Entry>> ring;
+};
+
+uint64_t isqrt(uint64_t n) {
+    uint64_t r = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+    while (r > 0 && static_cast<unsigned __int128>(r) * r > n) --r;
+    while (static_cast<unsigned __int128>(r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+/**
+ * @brief Primes from 7 up to `limit` with a plain odd-only sieve; these strike the segments.
+ */
+std::vector<uint32_t> sieving_primes(uint64_t limit) {
+    std::vector<uint32_t> primes;
+    if (limit < 7) return primes;
+    std::vector<bool> composite(limit / 2 + 1, false); // index i stands for 2i + 1
+    for (uint64_t i = 1; 2 * i + 1 <= limit; ++i) {
+        if (composite[i]) continue;
+        uint64_t p = 2 * i + 1;
+        if (p >= 7) primes.push_back(static_cast<uint32_t>(p));
+        for (uint64_t j = p * p / 2; 2 * j + 1 <= limit; j += p) {
+            composite[j] = true;
+        }
+    }
+    return primes;
+}
+
+/**
+ * @brief Calls `emit(n)` for every number whose bit is set in `bytes`, a segment starting at `base`.
+ */
+template <class Emit>
+void for_each_set(uint64_t base, const std::vector<uint8_t>& bytes, Emit emit) {
+    for (size_t b = 0; b < bytes.size(); ++b) {
+        for (unsigned int bits = bytes[b]; bits != 0; bits &= bits - 1) {
+            emit(base + b * WHEEL + WHEEL_RESIDUES[__builtin_ctz(bits)]);
+        }
+    }
+}
+
+/**
+ * @brief The sieve for one range: wheel bytes [first_byte, end_byte) cut into segments.
+ */
+class SegmentedSieve {
+public:
+    SegmentedSieve(uint64_t low, uint64_t high)
+        : low(low), high(high), first_byte(low / WHEEL),
+          end_byte(high == 0 ? 0 : (high - 1) / WHEEL + 1),
+          primes(sieving_primes(std::min(high == 0 ? 0 : isqrt(high - 1), STORED_PRIME_LIMIT))) {}
+
+    size_t segment_count() const {
+        return static_cast<size_t>((end_byte - first_byte + SEGMENT_BYTES - 1) / SEGMENT_BYTES);
+    }
+
+    /**
+     * @brief Sieves segments [begin, end) in order, calling `visit(index, bytes)` for each; a set
+     *        bit in `bytes` marks a prime in [low, high).
+     *
+     * Every sieving prime's first multiple per wheel residue is located once per run (one
+     * division). Primes smaller than the run carry those offsets from segment to segment;
+     * larger ones hit each residue at most once per run, so their hits are filed under the
+     * segment they land in. Offsets are relative to the run start, so nothing overflows near
+     * 2^64. Primes above STORED_PRIME_LIMIT come from the calling thread's `buckets`, which
+     * then requires `begin` to be a multiple of RUN_SEGMENTS and runs to arrive in order;
+     * ranges below 2^40 never touch them.
+     */
+    template <class Visit>
+    void sieve_run(size_t begin, size_t end, Visit visit, LargePrimeBuckets* buckets) const {
+        uint64_t run_byte = first_byte + begin * SEGMENT_BYTES;
+        uint64_t run_low = run_byte * WHEEL;
+        uint64_t run_bytes = std::min<uint64_t>(end_byte, first_byte + end * SEGMENT_BYTES) - run_byte;
+        unsigned __int128 run_last = static_cast<unsigned __int128>(run_low) + run_bytes * WHEEL - 1;
+        uint64_t limit = isqrt(static_cast<uint64_t>(std::min<unsigned __int128>(run_last, high - 1)));
+
+        // Byte offset and clear-mask of the first multiple p * q (q >= p, q coprime to 30) in
+        // each wheel residue; false once p^2 lies past the run.
+        auto locate = [&](uint64_t p, uint64_t* offsets, uint8_t* masks) {
+            uint64_t square = p * p;
+            if (square >= run_low && (square - run_low) / WHEEL >= run_bytes) return false;
+            uint64_t q_start;
+            uint64_t first;
+            if (square >= run_low) {
+                q_start = p;
+                first = square - run_low;
+            } else {
+                uint64_t rem = run_low % p;
+                q_start = run_low / p + (rem != 0);
+                first = rem == 0 ? 0 : p - rem;
+            }
+            for (int k = 0; k < 8; ++k) {
+                uint64_t offset = first + p * ((WHEEL_RESIDUES[k] + WHEEL - q_start % WHEEL) % WHEEL);
+                offsets[k] = offset / WHEEL;
+                masks[k] = static_cast<uint8_t>(~(1u << RESIDUE_BIT[offset % WHEEL]));
+            }
+            return true;
+        };
+
+        std::vector<uint64_t> next;
+        std::vector<uint8_t> next_masks;
+        size_t carried = 0;
+        uint64_t offsets[8];
+        uint8_t masks[8];
+        for (; carried < primes.size() && primes[carried] < run_bytes; ++carried) {
+            if (!locate(primes[carried], offsets, masks)) break;
+            next.insert(next.end(), offsets, offsets + 8);
+            next_masks.insert(next_masks.end(), masks, masks + 8);
+        }
+        carried = next.size() / 8;
+
+        SegmentHits hits(end - begin);
+        for (size_t i = carried; i < primes.size() && locate(primes[i], offsets, masks); ++i) {
+            for (int k = 0; k < 8; ++k) {
+                if (offsets[k] < run_bytes) {
+                    hits[offsets[k] / SEGMENT_BYTES].push_back(
+                        std::make_pair(static_cast<uint32_t>(offsets[k] % SEGMENT_BYTES), masks[k]));
+                }
+            }
+        }
+        if (limit > STORED_PRIME_LIMIT) {
+            buckets->collect(*this, begin / RUN_SEGMENTS, run_bytes, limit, hits);
+        }
+
+        std::vector<uint8_t> bytes;
+        for (size_t index = begin; index < end; ++index) {
+            uint64_t seg_start = (index - begin) * SEGMENT_BYTES;
+            uint64_t seg_end = std::min<uint64_t>(run_bytes, seg_start + SEGMENT_BYTES);
+            bytes.assign(static_cast<size_t>(seg_end - seg_start), 0xFF);
+
+            for (size_t i = 0; i < carried; ++i) {
+                uint64_t p = primes[i];
+                for (size_t k = i * 8; k < i * 8 + 8; ++k) {
+                    uint64_t b = next[k];
+                    for (; b < seg_end; b += p) {
+                        bytes[b - seg_start] &= next_masks[k];
+                    }
+                    next[k] = b;
+                }
+            }
+            for (const auto& hit : hits[index - begin]) {
+                bytes[hit.first] &= hit.second;
+            }
+
+            // Clear 1 and anything outside [low, high) in the first and last bytes.
+            uint64_t seg_low = run_low + seg_start * WHEEL;
+            for (size_t b : {size_t(0), bytes.size() - 1}) {
+                for (int bit = 0; bit < 8; ++bit) {
+                    unsigned __int128 value = static_cast<unsigned __int128>(seg_low) + b * WHEEL + WHEEL_RESIDUES[bit];
+                    if (value < low || value >= high || value == 1) {
+                        bytes[b] &= static_cast<uint8_t>(~(1u << bit));
+                    }
+                }
+            }
+            visit(index, bytes);
+        }
+    }
+
+    uint64_t segment_base(size_t index) const {
+        return (first_byte + index * SEGMENT_BYTES) * WHEEL;
+    }
+
+    uint64_t run_base(uint64_t run) const { return segment_base(run * RUN_SEGMENTS); }
+    uint64_t range_end() const { return high; }
+    uint64_t sieving_limit() const { return high == 0 ? 0 : isqrt(high - 1); }
+
+    /**
+     * @brief 2, 3 and 5, which the wheel leaves out, when they fall in the range.
+     */
+    std::vector<uint64_t> wheel_primes() const {
+        std::vector<uint64_t> result;
+        for (uint64_t p : {2, 3, 5}) {
+            if (p >= low && p < high) result.push_back(p);
+        }
+        return result;
+    }
+
+private:
+    uint64_t low;
+    uint64_t high;
+    uint64_t first_byte;
+    uint64_t end_byte;
+    std::vector<uint32_t> primes;
+};
+
+/**
+ * @brief Files `prime` under the run holding run_base(run) + offset, unless that is past the range.
+ */
+void LargePrimeBuckets::file(const SegmentedSieve& sieve, uint64_t run, uint32_t prime, uint64_t offset) {
+    if (offset >= sieve.range_end() - sieve.run_base(run)) return;
+    Entry entry = {prime, static_cast<uint32_t>(offset % RUN_SPAN)};
+    ring[(run + offset / RUN_SPAN) % ring.size()].push_back(entry);
+}
+
+/**
+ * @brief Files the hits of every sieving prime in (STORED_PRIME_LIMIT, limit] on run `run`,
+ *        `run_bytes` wheel bytes long, and moves each prime on to its next run.
+ */
+void LargePrimeBuckets::collect(const SegmentedSieve& sieve, uint64_t run, uint64_t run_bytes, uint64_t limit,
+                                SegmentHits& hits) {
+    const uint64_t run_low = sieve.run_base(run);
+    if (!started) {
+        ring.resize(2 * sieve.sieving_limit() / RUN_SPAN + 2);
+        next_run = run;
+        started = true;
+    }
+
+    // Primes waiting in skipped runs jump to their first odd multiple at or after run_low.
+    if (next_run < run) {
+        std::vector<std::pair<uint64_t, Entry>> waiting;
+        for (uint64_t r = next_run; r < run && r < next_run + ring.size(); ++r) {
+            std::vector<Entry>& bucket = ring[r % ring.size()];
+            for (const Entry& entry : bucket) {
+                waiting.push_back(std::make_pair(r, entry));
+            }
+            bucket.clear();
+        }
+        for (const auto& w : waiting) {
+            uint64_t behind = run_low - (sieve.run_base(w.first) + w.second.offset);
+            uint64_t step = 2 * uint64_t(w.second.prime);
+            file(sieve, run, w.second.prime, (step - behind % step) % step);
+        }
+    }
+    next_run = run + 1;
+
+    // Primes whose square has been reached join here, starting at p^2 or at their first odd
+    // multiple in this run. Their own sieving primes are at most 2^16, so the nested sieve
+    // leaves its buckets untouched.
+    if (limit > generated) {
+        SegmentedSieve base(generated + 1, limit + 1);
+        LargePrimeBuckets unused;
+        base.sieve_run(0, base.segment_count(), [&](size_t index, const std::vector<uint8_t>& bytes) {
+            for_each_set(base.segment_base(index), bytes, [&](uint64_t p) {
+                uint64_t square = p * p;
+                uint64_t offset;
+                if (square >= run_low) {
+                    offset = square - run_low;
+                } else {
+                    uint64_t rem = run_low % p;
+                    offset = rem == 0 ? 0 : p - rem;
+                    if (offset % 2 == 0) offset += p; // run_low is even, so odd offset = odd multiple
+                }
+                file(sieve, run, static_cast<uint32_t>(p), offset);
+            });
+        }, &unused);
+        generated = limit;
+    }
+
+    std::vector<Entry> current;
+    current.swap(ring[run % ring.size()]);
+    const uint64_t run_span = run_bytes * WHEEL;
+    for (const Entry& entry : current) {
+        uint64_t step = 2 * uint64_t(entry.prime);
+        uint64_t offset = entry.offset;
+        for (; offset < run_span; offset += step) {
+            int bit = RESIDUE_BIT[offset % WHEEL];
+            if (bit < 0) continue;
+            uint64_t byte = offset / WHEEL;
+            hits[byte / SEGMENT_BYTES].push_back(std::make_pair(
+                static_cast<uint32_t>(byte % SEGMENT_BYTES), static_cast<uint8_t>(~(1u << bit))));
+        }
+        file(sieve, run, entry.prime, offset);
+    }
+    // Reuse the bucket's storage; nothing new can have been filed under this run.
+    current.clear();
+    ring[run % ring.size()].swap(current);
+}
+
+/**
+ * @brief Runs `work(thread, first, last)` over segments [0, end) in runs of RUN_SEGMENTS,
+ *        giving each thread one contiguous share of the runs, visited in order, so its
+ *        LargePrimeBuckets never has to skip ahead.
+ */
+template <class Work>
+void run_slices(size_t end, unsigned int threads, Work work) {
+    size_t runs = (end + RUN_SEGMENTS - 1) / RUN_SEGMENTS;
+    auto worker = [&](unsigned int thread) {
+        size_t first_run = runs * thread / threads;
+        size_t last_run = runs * (thread + 1) / threads;
+        for (size_t run = first_run; run < last_run; ++run) {
+            work(thread, run * RUN_SEGMENTS, std::min(end, (run + 1) * RUN_SEGMENTS));
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; ++t) {
+        workers.push_back(std::thread(worker, t));
+    }
+    worker(0);
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+/**
+ * @brief Runs `work(thread, first, last)` over segments [begin, end) in runs of RUN_SEGMENTS,
+ *        each thread claiming the next unclaimed run until none are left.
+ */
+template <class Work>
+void run_segments(size_t begin, size_t end, unsigned int threads, Work work) {
+    std::atomic<size_t> next(begin);
+    auto worker = [&](unsigned int thread) {
+        for (size_t first = next.fetch_add(RUN_SEGMENTS); first < end; first = next.fetch_add(RUN_SEGMENTS)) {
+            work(thread, first, std::min(end, first + RUN_SEGMENTS));
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; ++t) {
+        workers.push_back(std::thread(worker, t));
+    }
+    worker(0);
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Counts the primes in [low, high) with a multi-threaded segmented sieve.
+ *
+ * The range is sieved in L1-sized segments of a mod-30 wheel, one bit per number coprime
+ * to 30; each thread sieves one contiguous share of the runs and counts set bits.
+ *
+ * @param low Inclusive lower bound.
+ * @param high Exclusive upper bound.
+ * @param threads Number of sieving threads.
+ * @return The number of primes p with low <= p < high.
+ */
+uint64_t count_primes(uint64_t low, uint64_t high, unsigned int threads) {
+    if (high <= low) return 0;
+    if (threads == 0) threads = 1;
+    SegmentedSieve sieve(low, high);
+
+    std::vector<uint64_t> counts(threads, 0);
+    std::vector<LargePrimeBuckets> buckets(threads);
+    run_slices(sieve.segment_count(), threads, [&](unsigned int thread, size_t first, size_t last) {
+        sieve.sieve_run(first, last, [&](size_t, const std::vector<uint8_t>& bytes) {
+            uint64_t count = 0;
+            for (uint8_t byte : bytes) {
+                count += __builtin_popcount(byte);
+            }
+            counts[thread] += count;
+        }, &buckets[thread]);
+    });
+
+    uint64_t total = sieve.wheel_primes().size();
+    for (uint64_t count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+/**
+ * @brief Calls `callback` for every prime in [low, high), in ascending order, on the calling
+ *        thread.
+ *
+ * Segments are sieved in rounds of one run per thread; once a round is done its primes are
+ * streamed out in order, so no more than one round of segments is held in memory.
+ *
+ * @param low Inclusive lower bound.
+ * @param high Exclusive upper bound.
+ * @param callback Receives each prime.
+ * @param threads Number of sieving threads.
+ */
+void for_each_prime(uint64_t low, uint64_t high, const PrimeCallback& callback, unsigned int threads) {
+    if (high <= low) return;
+    if (threads == 0) threads = 1;
+    SegmentedSieve sieve(low, high);
+
+    for (uint64_t p : sieve.wheel_primes()) {
+        callback(p);
+    }
+
+    const size_t round = threads * RUN_SEGMENTS;
+    std::vector<LargePrimeBuckets> buckets(threads);
+    std::vector<std::vector<uint8_t>> buffers(round);
+    for (size_t begin = 0; begin < sieve.segment_count(); begin += round) {
+        size_t end = std::min(sieve.segment_count(), begin + round);
+        run_segments(begin, end, threads, [&](unsigned int thread, size_t first, size_t last) {
+            sieve.sieve_run(first, last, [&](size_t index, const std::vector<uint8_t>& bytes) {
+                buffers[index - begin] = bytes;
+            }, &buckets[thread]);
+        });
+
+        for (size_t index = begin; index < end; ++index) {
+            const std::vector<uint8_t>& bytes = buffers[index - begin];
+            for_each_set(sieve.segment_base(index), bytes, [&](uint64_t p) { callback(p); });
+        }
+    }
+}
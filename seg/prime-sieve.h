@@ -0,0 +1,23 @@
+#ifndef PRIME_SIEVE_H
+#define PRIME_SIEVE_H
+
+#include <cstdint>
+#include <functional>
+
+typedef std::function<void(uint64_t)> PrimeCallback;
+
+uint64_t count_primes(uint64_t low, uint64_t high, unsigned int threads = 1);
+void for_each_prime(uint64_t low, uint64_t high, const PrimeCallback& callback, unsigned int threads = 1);
+
+/**
+ * @brief Writes every prime in [low, high) to `out`, in ascending order.
+ *
+ * @return The output iterator one past the last prime written.
+ */
+template <class OutputIt>
+OutputIt copy_primes(uint64_t low, uint64_t high, OutputIt out, unsigned int threads = 1) {
+    for_each_prime(low, high, [&out](uint64_t p) { *out++ = p; }, threads);
+    return out;
+}
+
+#endif // PRIME_SIEVE_H
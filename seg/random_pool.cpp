@@ -0,0 +1,161 @@
+#include <chrono>
+#include <stdexcept>
+#include "random_pool.h"
+#include "xorshift.h"
+#include "cmwc.h"
+
+/**
+ * @brief Starts the producer threads and begins filling the pool.
+ *
+ * @param bits The size of the numbers held by the pool.
+ * @param factory Called once per producer to build that producer's private generator.
+ * @param depth Maximum number of ready numbers kept in the pool (rounded up to a power of two).
+ * @param producers Number of background threads filling the pool.
+ */
+RandomPool::RandomPool(int bits, GeneratorFactory factory, size_t depth, unsigned int producers)
+    : num_bits(bits), queue(depth), running(true), produced(0), consumed(0),
+      producer_stalls(0), consumer_stalls(0) {
+    if (producers == 0) {
+        throw std::invalid_argument("A random pool needs at least one producer.");
+    }
+    // Build every generator up front so an invalid bit size is reported to the caller
+    // instead of terminating a producer thread.
+    std::vector<Generator> generators;
+    for (unsigned int i = 0; i < producers; ++i) {
+        generators.push_back(factory(i));
+    }
+    for (unsigned int i = 0; i < producers; ++i) {
+        workers.push_back(std::thread(&RandomPool::produce, this, generators[i]));
+    }
+}
+
+RandomPool::~RandomPool() {
+    stop();
+}
+
+/**
+ * @brief Stops and joins the producer threads. Numbers already queued stay available.
+ */
+void RandomPool::stop() {
+    running.store(false);
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+}
+
+/**
+ * @brief Producer loop: generate one number, then wait for room in the buffer.
+ *
+ * While the buffer is full the producer first yields a few times and then sleeps with
+ * an increasing delay, which is what bounds the pool at its configured depth.
+ */
+void RandomPool::produce(Generator generator) {
+    while (running.load(std::memory_order_relaxed)) {
+        BigInt value = generator();
+        unsigned int attempts = 0;
+        while (!queue.try_push(value)) {
+            if (!running.load(std::memory_order_relaxed)) return;
+            if (attempts == 0) producer_stalls.fetch_add(1, std::memory_order_relaxed);
+            if (attempts < 16) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(attempts < 64 ? 10 : 200));
+            }
+            ++attempts;
+        }
+        produced.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Takes a number from the pool without waiting.
+ * @return false if the pool is currently empty.
+ */
+bool RandomPool::try_next(BigInt& out) {
+    if (queue.try_pop(out)) {
+        consumed.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Takes a number from the pool, waiting for the producers if it is empty.
+ */
+BigInt RandomPool::next() {
+    BigInt value(uint64_t(0));
+    if (try_next(value)) return value;
+
+    consumer_stalls.fetch_add(1, std::memory_order_relaxed);
+    while (!try_next(value)) {
+        if (!running.load(std::memory_order_relaxed)) {
+            throw std::runtime_error("Random pool is stopped and empty.");
+        }
+        std::this_thread::yield();
+    }
+    return value;
+}
+
+RandomPool::Stats RandomPool::stats() const {
+    Stats s;
+    s.produced = produced.load();
+    s.consumed = consumed.load();
+    s.producer_stalls = producer_stalls.load();
+    s.consumer_stalls = consumer_stalls.load();
+    return s;
+}
+
+RandomService::RandomService(GeneratorFactory factory, size_t depth, unsigned int producers)
+    : factory(factory), depth(depth), producers(producers) {}
+
+/**
+ * @brief Returns the pool for a bit size, starting it on first use.
+ */
+RandomPool& RandomService::pool(int bits) {
+    std::lock_guard<std::mutex> lock(pools_mutex);
+    auto it = pools.find(bits);
+    if (it == pools.end()) {
+        GeneratorFactory f = factory;
+        RandomPool::GeneratorFactory per_size = [f, bits](unsigned int index) { return f(bits, index); };
+        it = pools.insert(std::make_pair(bits, std::unique_ptr<RandomPool>(
+                 new RandomPool(bits, per_size, depth, producers)))).first;
+    }
+    return *it->second;
+}
+
+BigInt RandomService::next(int bits) {
+    return pool(bits).next();
+}
+
+/**
+ * @brief Builds a stateful Xorshift generator that advances one state per call.
+ *
+ * @param bits The size of the generated numbers. Must be one of the supported sizes.
+ * @param seed Initial state; producers should pass distinct seeds.
+ */
+RandomPool::Generator make_xorshift_generator(int bits, uint64_t seed) {
+    xorshift_params(bits); // validates the size
+    std::shared_ptr<BigInt> state(new BigInt(static_cast<unsigned int>(bits)));
+    state->seed(seed == 0 ? 1 : seed);
+    return [state, bits]() {
+        xorshift_next(*state, bits);
+        return *state;
+    };
+}
+
+/**
+ * @brief Builds a CMWC generator whose stream continues across calls.
+ *
+ * @param bits The size of the generated numbers. Must be one of the supported sizes.
+ * @param seed Seed for the CMWC state; producers should pass distinct seeds.
+ */
+RandomPool::Generator make_cmwc_generator(int bits, uint64_t seed) {
+    if (!is_supported(bits)) {
+        throw std::invalid_argument("Invalid bit size selected.");
+    }
+    std::shared_ptr<CMWC> cmwc(new CMWC(seed));
+    return [cmwc, bits]() {
+        return generate_random_cmwc(bits, *cmwc);
+    };
+}
@@ -0,0 +1,91 @@
+#ifndef RANDOM_POOL_H
+#define RANDOM_POOL_H
+
+#include "bigint.h"
+#include "ring_buffer.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Background-filled queue of ready-made random BigInts of one bit size.
+ *
+ * A fixed number of producer threads, each with its own generator state, keep a
+ * lock-free ring buffer topped up. Producers back off (yield, then sleep) while the
+ * buffer is full, so the pool never holds more than `depth` numbers; consumers pop
+ * from the buffer and only wait when producers cannot keep up.
+ */
+class RandomPool {
+public:
+    typedef std::function<BigInt()> Generator;
+    typedef std::function<Generator(unsigned int producer_index)> GeneratorFactory;
+
+    struct Stats {
+        uint64_t produced;
+        uint64_t consumed;
+        uint64_t producer_stalls; // times a producer found the buffer full
+        uint64_t consumer_stalls; // times a consumer found the buffer empty
+    };
+
+    RandomPool(int bits, GeneratorFactory factory, size_t depth = 1024, unsigned int producers = 1);
+    ~RandomPool();
+
+    RandomPool(const RandomPool&) = delete;
+    RandomPool& operator=(const RandomPool&) = delete;
+
+    BigInt next();
+    bool try_next(BigInt& out);
+    void stop();
+
+    int bits() const { return num_bits; }
+    size_t available() const { return queue.size(); }
+    size_t depth() const { return queue.capacity(); }
+    Stats stats() const;
+
+private:
+    void produce(Generator generator);
+
+    int num_bits;
+    RingBuffer<BigInt> queue;
+    std::vector<std::thread> workers;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> produced;
+    std::atomic<uint64_t> consumed;
+    std::atomic<uint64_t> producer_stalls;
+    std::atomic<uint64_t> consumer_stalls;
+};
+
+/**
+ * @brief Hands out random numbers of any supported size from one RandomPool per size.
+ *
+ * Pools are created lazily on the first request for a size and share the same depth,
+ * producer count and generator family.
+ */
+class RandomService {
+public:
+    typedef std::function<RandomPool::Generator(int bits, unsigned int producer_index)> GeneratorFactory;
+
+    RandomService(GeneratorFactory factory, size_t depth = 1024, unsigned int producers = 1);
+
+    BigInt next(int bits);
+    RandomPool& pool(int bits);
+
+private:
+    GeneratorFactory factory;
+    size_t depth;
+    unsigned int producers;
+    std::mutex pools_mutex;
+    std::map<int, std::unique_ptr<RandomPool>> pools;
+};
+
+typedef std::function<RandomPool::Generator(int bits, uint64_t seed)> GeneratorMaker;
+
+RandomPool::Generator make_xorshift_generator(int bits, uint64_t seed);
+RandomPool::Generator make_cmwc_generator(int bits, uint64_t seed);
+
+#endif // RANDOM_POOL_H
@@ -0,0 +1,295 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+#include <stdexcept>
+
+#include "bigint.h"
+#include "random_pool.h"
+#include "stat_tests.h"
+
+const size_t CHUNK_WORDS = 1 << 16; // 512 KiB per chunk; a multiple of the 128-bit block size
+
+/**
+ * @brief Packs the low `bits` bits of successive numbers into a contiguous bit stream and
+ *        hands each full chunk to a BitStats.
+ */
+class StreamPacker {
+public:
+    StreamPacker(BitStats& stats, size_t birthday_budget)
+        : stats(stats), birthday_budget(birthday_budget), chunk(CHUNK_WORDS + 1, 0), pos(0) {}
+
+    void append(const BigInt& value, int bits) {
+        const uint64_t* limbs = value.limb_data();
+        size_t count = value.limb_count();
+        for (int consumed = 0, limb = 0; consumed < bits; consumed += 64, ++limb) {
+            unsigned int n = std::min(64, bits - consumed);
+            uint64_t word = size_t(limb) < count ? limbs[limb] : 0;
+            if (n < 64) word &= (uint64_t(1) << n) - 1;
+            append_bits(word, n);
+        }
+    }
+
+    void finish() {
+        if (pos > 0) stats.add(chunk.data(), pos);
+        pos = 0;
+    }
+
+private:
+    void append_bits(uint64_t word, unsigned int n) {
+        size_t index = pos / 64;
+        unsigned int offset = pos % 64;
+        chunk[index] |= word << offset;
+        if (offset + n > 64) chunk[index + 1] |= word >> (64 - offset);
+        pos += n;
+        if (pos >= CHUNK_WORDS * 64) flush();
+    }
+
+    void flush() {
+        stats.add(chunk.data(), CHUNK_WORDS * 64);
+        for (size_t i = 0; birthday_budget > 0 && i + BIRTHDAY_WORDS <= CHUNK_WORDS; i += BIRTHDAY_WORDS) {
+            stats.add_birthday_sample(&chunk[i]);
+            --birthday_budget;
+        }
+        uint64_t carry = chunk[CHUNK_WORDS];
+        std::fill(chunk.begin(), chunk.end(), 0);
+        chunk[0] = carry;
+        pos -= CHUNK_WORDS * 64;
+    }
+
+    BitStats& stats;
+    size_t birthday_budget;
+    std::vector<uint64_t> chunk;
+    size_t pos;
+};
+
+/**
+ * @brief Runs the battery over `total_bytes` of output from one generator and bit size.
+ *
+ * The stream is the concatenation of one independently seeded sub-stream per thread; each
+ * thread counts its own sub-stream and the per-thread statistics are merged in order. The
+ * generators are built on the calling thread, so an unsupported bit size surfaces here as
+ * std::invalid_argument instead of terminating a worker.
+ */
+BitStats test_generator(const GeneratorMaker& make_generator, int bits, uint64_t total_bytes,
+                        unsigned int threads, uint64_t seed, size_t birthday_samples) {
+    if (bits <= 0) {
+        throw std::invalid_argument("Bit size must be positive.");
+    }
+    std::vector<RandomPool::Generator> generators;
+    for (unsigned int t = 0; t < threads; ++t) {
+        generators.push_back(make_generator(bits, seed ^ (0x9E3779B97F4A7C15ULL * t)));
+    }
+    std::vector<BitStats> partial(threads);
+    uint64_t numbers_per_thread = (total_bytes * 8 / bits + threads - 1) / threads;
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&, t]() {
+            RandomPool::Generator& generate = generators[t];
+            StreamPacker packer(partial[t], (birthday_samples + threads - 1) / threads);
+            for (uint64_t i = 0; i < numbers_per_thread; ++i) {
+                packer.append(generate(), bits);
+            }
+            packer.finish();
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    BitStats merged;
+    for (const auto& p : partial) {
+        merged.merge(p);
+    }
+    return merged;
+}
+
+/**
+ * @brief Checks the p-value code against the worked examples in NIST SP 800-22 (section 2).
+ */
+void validate_statistics() {
+    std::cout << "Validating statistical tests against NIST SP 800-22 examples..." << std::endl;
+
+    auto bits_of = [](const std::string& epsilon) {
+        uint64_t word = 0;
+        for (size_t i = 0; i < epsilon.size(); ++i) {
+            if (epsilon[i] == '1') word |= uint64_t(1) << i;
+        }
+        return word;
+    };
+
+    // 2.1.8: monobit on 1011010101 gives P = 0.527089.
+    uint64_t monobit = bits_of("1011010101");
+    BitStats a;
+    a.add(&monobit, 10);
+    assert(std::fabs(evaluate(a)[0].p_value - 0.527089) < 1e-6);
+
+    // 2.3.8: runs on 1001101011 gives V = 7 and P = 0.147232.
+    uint64_t runs = bits_of("1001101011");
+    BitStats b;
+    b.add(&runs, 10);
+    assert(evaluate(b)[1].statistic == 7.0);
+    assert(std::fabs(evaluate(b)[1].p_value - 0.147232) < 1e-6);
+
+    // 2.11.8: serial (m = 3) on 0011011101 gives del1 = 1.6, P1 = 0.808792 and
+    // del2 = 0.8, P2 = 0.670320.
+    uint64_t serial = bits_of("0011011101");
+    BitStats c;
+    c.add(&serial, 10);
+    std::vector<TestResult> serial_results = evaluate(c);
+    assert(std::fabs(serial_results[3].statistic - 1.6) < 1e-9);
+    assert(std::fabs(serial_results[3].p_value - 0.808792) < 1e-6);
+    assert(std::fabs(serial_results[4].statistic - 0.8) < 1e-9);
+    assert(std::fabs(serial_results[4].p_value - 0.670320) < 1e-6);
+
+    // Splitting the same bits across BitStats and merging must not change anything, including
+    // splits that leave one-bit pieces next to a join.
+    for (size_t cut : {1, 2, 5, 8, 9}) {
+        for (size_t cut2 = cut + 1; cut2 <= 10; ++cut2) {
+            BitStats first, second, third;
+            uint64_t head = serial & ((uint64_t(1) << cut) - 1);
+            uint64_t middle = (serial >> cut) & ((uint64_t(1) << (cut2 - cut)) - 1);
+            uint64_t tail = serial >> cut2;
+            first.add(&head, cut);
+            second.add(&middle, cut2 - cut);
+            third.add(&tail, 10 - cut2);
+            first.merge(second);
+            first.merge(third);
+            assert(first.transitions == c.transitions && first.pairs11 == c.pairs11 && first.ones == c.ones);
+            assert(first.triples111 == c.triples111 && first.triples101 == c.triples101);
+            assert(first.second_bit == c.second_bit && first.penultimate_bit == c.penultimate_bit);
+
+            BitStats streamed;
+            streamed.add(&head, cut);
+            streamed.add(&middle, cut2 - cut);
+            streamed.add(&tail, 10 - cut2);
+            assert(streamed.triples111 == c.triples111 && streamed.triples101 == c.triples101);
+        }
+    }
+
+    // Word-at-a-time triple counts, including triples that cross words, against a bit loop.
+    uint64_t words[3] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL};
+    for (size_t nbits : {3, 64, 65, 66, 128, 131, 192}) {
+        BitStats counted;
+        counted.add(words, nbits);
+        uint64_t t111 = 0, t101 = 0;
+        for (size_t i = 0; i + 2 < nbits; ++i) {
+            int x = (words[i / 64] >> (i % 64)) & 1;
+            int y = (words[(i + 1) / 64] >> ((i + 1) % 64)) & 1;
+            int z = (words[(i + 2) / 64] >> ((i + 2) % 64)) & 1;
+            t111 += x & y & z;
+            t101 += x & !y & z;
+        }
+        assert(counted.triples111 == t111 && counted.triples101 == t101);
+    }
+
+    // Chi-square tail: P(chi2_1 > 3.841459) = 0.05.
+    assert(std::fabs(chi_square_p_value(3.841459, 1) - 0.05) < 1e-6);
+
+    // Large degrees of freedom, as block frequency sees with millions of blocks: chi2_k is close
+    // to N(k, 2k), so the median sits near k and k + 2 sqrt(k) is about one standard deviation up.
+    for (double k : {2e4, 1e6, 4e6}) {
+        assert(std::fabs(chi_square_p_value(k, k) - 0.5) < 2e-3);
+        assert(std::fabs(chi_square_p_value(k + std::sqrt(2.0 * k), k) - 0.158655) < 2e-3);
+        assert(std::fabs(chi_square_p_value(k - std::sqrt(2.0 * k), k) - 0.841345) < 2e-3);
+    }
+
+    std::cout << "Statistical test validation passed!" << std::endl;
+}
+
+std::vector<int> parse_bit_sizes(const std::string& list) {
+    std::vector<int> sizes;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        sizes.push_back(std::atoi(item.c_str()));
+    }
+    return sizes;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t megabytes = 64;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> bit_sizes = {40, 56, 80, 128, 168, 224, 256, 512, 1024, 2048, 4096};
+    std::string generator = "all";
+    uint64_t seed = time(0);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--megabytes" && has_value) {
+            megabytes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && has_value) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--bits" && has_value) {
+            bit_sizes = parse_bit_sizes(argv[++i]);
+        } else if (arg == "--generator" && has_value) {
+            generator = argv[++i];
+        } else if (arg == "--seed" && has_value) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--megabytes N] [--threads N] [--bits 40,56,...]"
+                      << " [--generator xorshift|cmwc|all] [--seed N]" << std::endl;
+            return 1;
+        }
+    }
+
+    validate_statistics();
+
+    std::vector<std::pair<std::string, GeneratorMaker>> generators;
+    if (generator == "all" || generator == "xorshift") generators.push_back(std::make_pair("xorshift", make_xorshift_generator));
+    if (generator == "all" || generator == "cmwc") generators.push_back(std::make_pair("cmwc", make_cmwc_generator));
+
+    const size_t birthday_samples = 2000;
+    const char* names[] = {"monobit", "runs", "blockfreq", "serial1", "serial2", "poker", "bytes", "birthday"};
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Testing " << megabytes << " MB per generator and size on " << threads << " threads (seed " << seed << ")" << std::endl;
+    std::cout << "p-values; a test fails (*) below 0.01" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "| Generator | Bits | MB/s    |";
+    for (const char* name : names) {
+        std::cout << std::setw(10) << name << " |";
+    }
+    std::cout << std::endl;
+    std::cout << "--------------------------------------------------------------------------------------------------------------------" << std::endl;
+
+    for (const auto& g : generators) {
+        for (int bits : bit_sizes) {
+            try {
+                auto start = std::chrono::high_resolution_clock::now();
+                BitStats stats = test_generator(g.second, bits, megabytes << 20, threads, seed, birthday_samples);
+                auto end = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> elapsed = end - start;
+
+                std::cout << "| " << std::setw(9) << g.first << " | " << std::setw(4) << bits << " | "
+                          << std::setw(7) << std::setprecision(1) << stats.bits / 8e6 / elapsed.count() << " |"
+                          << std::setprecision(4);
+                for (const TestResult& r : evaluate(stats)) {
+                    if (r.p_value < 0) {
+                        std::cout << std::setw(10) << "n/a" << "  |";
+                    } else {
+                        std::cout << std::setw(10) << r.p_value << (r.p_value < 0.01 ? "*" : " ") << " |";
+                    }
+                }
+                std::cout << std::endl;
+            } catch (const std::invalid_argument& e) {
+                std::cerr << "Error: " << e.what() << " (" << bits << " bits)" << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "--------------------------------------------------------------------------------------------------------------------" << std::endl;
+
+    return 0;
+}
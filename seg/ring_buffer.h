@@ -0,0 +1,131 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free multi-producer/multi-consumer queue.
+ *
+ * Each cell carries a sequence number that tells producers and consumers whether the
+ * cell is free for writing or holds a value ready to be read (D. Vyukov's bounded MPMC
+ * design). Push and pop never block; callers decide how to back off when the queue is
+ * full or empty. The capacity is rounded up to a power of two, and to at least 2: with a
+ * single cell the sequence numbers of a full and an empty slot coincide.
+ */
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity) : cell_count(round_up(capacity)), cells(new Cell[cell_count]),
+                                           mask(cell_count - 1),
+                                           enqueue_pos(0), dequeue_pos(0) {
+        for (size_t i = 0; i < cell_count; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~RingBuffer() {
+        size_t head = dequeue_pos.load(std::memory_order_relaxed);
+        size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+        for (size_t pos = head; pos != tail; ++pos) {
+            reinterpret_cast<T*>(&cells[pos & mask].storage)->~T();
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Moves a value into the queue.
+     * @return false if the queue is full; the value is left untouched in that case.
+     */
+    bool try_push(T& value) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        new (&cell->storage) T(std::move(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Moves the oldest value out of the queue.
+     * @return false if the queue is empty.
+     */
+    bool try_pop(T& out) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        T* slot = reinterpret_cast<T*>(&cell->storage);
+        out = std::move(*slot);
+        slot->~T();
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of queued values; exact only when no thread is pushing or popping.
+     */
+    size_t size() const {
+        size_t head = dequeue_pos.load(std::memory_order_relaxed);
+        size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return cell_count; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    static size_t round_up(size_t n) {
+        if (n == 0) {
+            throw std::invalid_argument("Ring buffer capacity must be positive.");
+        }
+        size_t capacity = 2;
+        while (capacity < n) capacity <<= 1;
+        return capacity;
+    }
+
+    const size_t cell_count;
+    std::unique_ptr<Cell[]> cells;
+    const size_t mask;
+
+    // Producers and consumers hammer different counters; keep them on separate cache lines.
+    char pad0[64];
+    std::atomic<size_t> enqueue_pos;
+    char pad1[64];
+    std::atomic<size_t> dequeue_pos;
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,235 @@
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "safe-prime.h"
+#include "miller-rabin.h"
+
+namespace {
+
+const uint32_t SIEVE_LIMIT = 1 << 16;  // sieve by every odd prime below this
+const uint32_t SIEVE_WINDOW = 1 << 15; // q = start + 2j, 0 <= j < SIEVE_WINDOW, per window
+const size_t SCREEN_PRIMES = 168;      // odd primes 3..1009, tried before is_sprp_base2
+
+/**
+ * @brief Odd primes below SIEVE_LIMIT, computed once.
+ */
+const std::vector<uint32_t>& sieve_primes() {
+    static const std::vector<uint32_t> primes = [] {
+        std::vector<uint32_t> result;
+        std::vector<bool> composite(SIEVE_LIMIT, false);
+        for (uint32_t i = 3; i < SIEVE_LIMIT; i += 2) {
+            if (composite[i]) continue;
+            result.push_back(i);
+            for (uint64_t j = uint64_t(i) * i; j < SIEVE_LIMIT; j += 2 * i) {
+                composite[j] = true;
+            }
+        }
+        return result;
+    }();
+    return primes;
+}
+
+/**
+ * @brief Random value of exactly `bits` bits drawn word by word from the CMWC state.
+ */
+BigInt random_bits(int bits, CMWC& rng) {
+    std::vector<uint64_t> words((bits + 63) / 64);
+    for (auto& w : words) {
+        w = rng.next();
+    }
+    if (bits % 64 != 0) {
+        words.back() &= (uint64_t(1) << (bits % 64)) - 1;
+    }
+    BigInt value(uint64_t(0));
+    value.assign_limbs(words.data(), words.size());
+    value.set_bit(bits - 1, true);
+    return value;
+}
+
+BigInt random_odd_bits(int bits, CMWC& rng) {
+    BigInt value = random_bits(bits, rng);
+    value.set_bit(0, true);
+    return value;
+}
+
+/**
+ * @brief Smallest prime of the form start + i * step (i >= 0, start odd, step even), found
+ *        with a small-prime screen, is_sprp_base2, and then k rounds of Miller-Rabin.
+ */
+BigInt next_prime_in_progression(BigInt start, const BigInt& step, int k) {
+    const std::vector<uint32_t>& primes = sieve_primes();
+    for (;; start = start + step) {
+        bool divisible = false;
+        for (size_t i = 0; i < SCREEN_PRIMES && i < primes.size(); ++i) {
+            if (start.mod_small(primes[i]) == 0 && start != primes[i]) {
+                divisible = true;
+                break;
+            }
+        }
+        if (divisible) continue;
+        if (is_sprp_base2(start) && is_prime_miller_rabin(start, k)) return start;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Checks that p and (p - 1) / 2 are both (probable) primes.
+ */
+bool is_safe_prime(const BigInt& p, int k) {
+    if (p <= 5 || p.is_even()) return p == 5;
+    BigInt q = p - BigInt(uint64_t(1));
+    q >>= 1;
+    return is_prime_miller_rabin(q, k) && is_prime_miller_rabin(p, k);
+}
+
+/**
+ * @brief Finds a `bits`-bit safe prime p = 2q + 1 by sieving q and p together.
+ *
+ * Starting from a random odd q of bits - 1 bits, windows of consecutive odd q are sieved
+ * with one residue table: for each small prime l, a candidate is struck if q = 0 or
+ * q = (l - 1) / 2 (mod l), the latter being exactly the q for which l divides 2q + 1.
+ * Survivors get a base-2 strong probable-prime test on q and then on p, and only pairs
+ * passing both go to k rounds of Miller-Rabin each. With several threads, each takes the
+ * next unsearched window; the first pair found wins.
+ *
+ * @param bits Exact bit length of p; at least 8.
+ * @param k Miller-Rabin rounds for the final tests.
+ * @param rng Source of the random starting point.
+ * @param threads Number of search threads.
+ */
+SafePrime generate_safe_prime(int bits, int k, CMWC& rng, unsigned int threads) {
+    if (bits < 8) {
+        throw std::invalid_argument("Safe primes need at least 8 bits.");
+    }
+    if (threads == 0) threads = 1;
+
+    // Only sieve by primes smaller than every q we will look at, so q itself is never struck.
+    std::vector<uint32_t> primes;
+    for (uint32_t l : sieve_primes()) {
+        if (bits - 2 < 32 && l >= (uint64_t(1) << (bits - 2))) break;
+        primes.push_back(l);
+    }
+
+    for (;;) {
+        BigInt start = random_odd_bits(bits - 1, rng);
+
+        std::vector<uint32_t> residues(primes.size());
+        for (size_t i = 0; i < primes.size(); ++i) {
+            residues[i] = start.mod_small(primes[i]);
+        }
+
+        BigInt q_limit(uint64_t(1));
+        q_limit <<= bits - 1;
+
+        std::atomic<uint64_t> next_window(0);
+        std::atomic<bool> done(false);
+        std::atomic<bool> exhausted(false);
+        std::mutex result_mutex;
+        SafePrime result = {BigInt(uint64_t(0)), BigInt(uint64_t(0))};
+
+        auto search = [&]() {
+            std::vector<char> struck(SIEVE_WINDOW);
+            while (!done.load() && !exhausted.load()) {
+                uint64_t window = next_window.fetch_add(1);
+                uint64_t first = window * SIEVE_WINDOW; // index of the window's first candidate
+
+                std::fill(struck.begin(), struck.end(), 0);
+                for (size_t i = 0; i < primes.size(); ++i) {
+                    uint64_t l = primes[i];
+                    uint64_t half = (l + 1) / 2; // inverse of 2 mod l
+                    uint64_t r = (residues[i] + 2 * (first % l)) % l;
+                    // q = r + 2j: q = 0 when j = -r/2, and l | 2q + 1 when j = ((l - 1)/2 - r)/2.
+                    uint64_t j_q = (l - r) % l * half % l;
+                    uint64_t j_p = ((l - 1) / 2 + l - r) % l * half % l;
+                    for (uint64_t j = j_q; j < SIEVE_WINDOW; j += l) struck[j] = 1;
+                    for (uint64_t j = j_p; j < SIEVE_WINDOW; j += l) struck[j] = 1;
+                }
+
+                BigInt base = start + BigInt(2 * first);
+                for (uint32_t j = 0; j < SIEVE_WINDOW && !done.load(); ++j) {
+                    if (struck[j]) continue;
+                    BigInt q = base + BigInt(uint64_t(2) * j);
+                    if (q >= q_limit) {
+                        exhausted.store(true);
+                        return;
+                    }
+                    if (!is_sprp_base2(q)) continue;
+                    BigInt p = q + q + BigInt(uint64_t(1));
+                    if (!is_sprp_base2(p)) continue;
+                    if (!is_prime_miller_rabin(q, k) || !is_prime_miller_rabin(p, k)) continue;
+
+                    std::lock_guard<std::mutex> lock(result_mutex);
+                    if (!done.load()) {
+                        result.p = p;
+                        result.q = q;
+                        done.store(true);
+                    }
+                    return;
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int i = 1; i < threads; ++i) {
+            workers.push_back(std::thread(search));
+        }
+        search();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        if (done.load()) return result;
+        // Ran past 2^(bits - 1) without a hit: start again from a new random point.
+    }
+}
+
+/**
+ * @brief Gordon's algorithm for a `bits`-bit strong prime.
+ *
+ * Random primes s and t of about bits/2 bits are drawn, r is the first prime 2it + 1,
+ * p0 = 2 (s^(r-2) mod r) s - 1 satisfies p0 = 1 (mod r) and p0 = -1 (mod s), and p is the
+ * first prime p0 + 2jrs with the requested length. Every prime search uses a small-prime
+ * screen and a base-2 strong probable-prime test before Miller-Rabin.
+ *
+ * @param bits Exact bit length of p; at least 128.
+ * @param k Miller-Rabin rounds.
+ * @param rng Source of the random starting points.
+ */
+StrongPrime generate_strong_prime(int bits, int k, CMWC& rng) {
+    if (bits < 128) {
+        throw std::invalid_argument("Strong primes need at least 128 bits.");
+    }
+    const BigInt one(uint64_t(1));
+    const BigInt two(uint64_t(2));
+
+    for (;;) {
+        BigInt s = next_prime_in_progression(random_odd_bits(bits / 2 - 8, rng), two, k);
+        BigInt t = next_prime_in_progression(random_odd_bits(bits / 2 - 24, rng), two, k);
+
+        // r = 2it + 1 with i chosen so r has about bits/2 - 8 bits.
+        BigInt two_t = t + t;
+        BigInt i0 = random_bits(16, rng);
+        BigInt r = next_prime_in_progression(two_t * i0 + one, two_t, k);
+
+        BigInt rs = r * s;
+        BigInt two_rs = rs + rs;
+        BigInt p0 = two * BigInt::modular_pow(s, r - two, r) * s - one;
+
+        // Smallest p = p0 + 2jrs that has the requested bit length.
+        BigInt low(uint64_t(1));
+        low <<= bits - 1;
+        BigInt start = p0;
+        if (start < low) {
+            BigInt j = (low - p0 + two_rs - one) / two_rs;
+            start = p0 + j * two_rs;
+        }
+        BigInt p = next_prime_in_progression(start, two_rs, k);
+        if (p.bit_length() != static_cast<size_t>(bits)) continue;
+
+        StrongPrime result = {p, r, s, t};
+        return result;
+    }
+}
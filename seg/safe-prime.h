@@ -0,0 +1,29 @@
+#ifndef SAFE_PRIME_H
+#define SAFE_PRIME_H
+
+#include "bigint.h"
+#include "cmwc.h"
+
+/**
+ * @brief A safe prime p = 2q + 1 together with its Sophie Germain prime q.
+ */
+struct SafePrime {
+    BigInt p;
+    BigInt q;
+};
+
+/**
+ * @brief A strong prime p (Gordon): r | p - 1, s | p + 1 and t | r - 1 for large primes r, s, t.
+ */
+struct StrongPrime {
+    BigInt p;
+    BigInt r;
+    BigInt s;
+    BigInt t;
+};
+
+SafePrime generate_safe_prime(int bits, int k, CMWC& rng, unsigned int threads = 1);
+StrongPrime generate_strong_prime(int bits, int k, CMWC& rng);
+bool is_safe_prime(const BigInt& p, int k);
+
+#endif // SAFE_PRIME_H
@@ -0,0 +1,150 @@
+#include <stdexcept>
+#include "shawe-taylor.h"
+
+namespace {
+
+// Primes below this many bits are produced and checked directly by trial division.
+const int BASE_PRIME_BITS = 32;
+
+const uint64_t SMALL_PRIMES[] = {
+    3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97,
+    101, 103, 107, 109, 113, 127, 131, 137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191,
+    193, 197, 199, 211, 223, 227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283,
+    293, 307, 311, 313, 317, 331, 337, 347, 349, 353, 359, 367, 373, 379, 383, 389, 397, 401,
+    409, 419, 421, 431, 433, 439, 443, 449, 457, 461, 463, 467, 479, 487, 491, 499, 503, 509,
+    521, 523, 541, 547, 557, 563, 569, 571, 577, 587, 593, 599, 601, 607, 613, 617, 619, 631,
+    641, 643, 647, 653, 659, 661, 673, 677, 683, 691, 701, 709, 719, 727, 733, 739, 743, 751,
+    757, 761, 769, 773, 787, 797, 809, 811, 821, 823, 827, 829, 839, 853, 857, 859, 863, 877,
+    881, 883, 887, 907, 911, 919, 929, 937, 941, 947, 953, 967, 971, 977, 983, 991, 997
+};
+
+bool is_prime_trial_division(uint64_t n) {
+    if (n < 2) return false;
+    if (n % 2 == 0) return n == 2;
+    for (uint64_t d = 3; d <= n / d; d += 2) {
+        if (n % d == 0) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief True if `n` has no prime factor below 1000 (other than itself).
+ */
+bool passes_small_prime_sieve(const BigInt& n) {
+    for (uint64_t p : SMALL_PRIMES) {
+        if (n.mod_small(p) == 0) return n == p;
+    }
+    return true;
+}
+
+/**
+ * @brief Uniform-enough random value in [0, bound): 64 extra bits make the modulo bias negligible.
+ */
+BigInt random_below(const BigInt& bound, CMWC& rng) {
+    size_t limbs = (bound.bit_length() + 63) / 64 + 1;
+    std::vector<uint64_t> words(limbs);
+    for (auto& w : words) {
+        w = rng.next();
+    }
+    BigInt value(uint64_t(0));
+    value.assign_limbs(words.data(), words.size());
+    return value % bound;
+}
+
+/**
+ * @brief Checks a single Pocklington step: q | p - 1, q^2 > p, a^(p-1) = 1 and
+ *        gcd(a^((p-1)/q) - 1, p) = 1 (mod p).
+ */
+bool verify_step(const PocklingtonStep& step) {
+    const BigInt one(uint64_t(1));
+    if (step.p <= 3 || step.q.is_zero() || step.a < 2 || step.a >= step.p) return false;
+    BigInt p_minus_1 = step.p - one;
+    if (!(p_minus_1 % step.q).is_zero()) return false;
+    if (step.q * step.q <= step.p) return false;
+
+    BigInt z = BigInt::modular_pow(step.a, p_minus_1 / step.q, step.p);
+    if (z.is_zero() || BigInt::modular_pow(z, step.q, step.p) != one) return false;
+    return BigInt::gcd(z - one, step.p) == one;
+}
+
+} // namespace
+
+/**
+ * @brief Builds a proven prime of exactly `bits` bits by Shawe-Taylor-style recursion.
+ *
+ * A prime q of (bits + 1) / 2 + 1 bits is proven first, so that q > sqrt(p) for every
+ * bits-bit p. Candidates p = 2tq + 1 with random t are sieved by the primes below 1000,
+ * then a base a is searched for that satisfies Pocklington's criterion; z = a^(2t) is
+ * computed once and reused for both the Fermat condition (z^q = 1) and the gcd.
+ *
+ * @param bits The exact bit length of the prime; at least 2.
+ * @param rng Source of the random multipliers t and of the small base prime.
+ * @return The prime together with the certificate proving it.
+ */
+PrimeCertificate generate_provable_prime(int bits, CMWC& rng) {
+    if (bits < 2) {
+        throw std::invalid_argument("Number of bits must be at least 2.");
+    }
+
+    if (bits <= BASE_PRIME_BITS) {
+        uint64_t low = uint64_t(1) << (bits - 1);
+        for (;;) {
+            uint64_t candidate = low | (rng.next() & (low - 1)) | 1;
+            if (is_prime_trial_division(candidate)) {
+                PrimeCertificate certificate;
+                certificate.base_prime = BigInt(candidate);
+                return certificate;
+            }
+        }
+    }
+
+    PrimeCertificate certificate = generate_provable_prime((bits + 1) / 2 + 1, rng);
+    const BigInt q = certificate.prime();
+    const BigInt one(uint64_t(1));
+
+    // p = 2tq + 1 lies in [2^(bits-1), 2^bits) for t in [ceil(2^(bits-2) / q), floor((2^(bits-1) - 1) / q)].
+    BigInt low(uint64_t(1));
+    low <<= bits - 2;
+    BigInt high(uint64_t(1));
+    high <<= bits - 1;
+    BigInt t_min = (low + q - one) / q;
+    BigInt t_span = (high - one) / q - t_min + one;
+
+    for (;;) {
+        BigInt t = t_min + random_below(t_span, rng);
+        BigInt two_t = t + t;
+        BigInt p = two_t * q + one;
+        if (!passes_small_prime_sieve(p)) continue;
+
+        // A prime p accepts almost every base; give up on p after a few and draw another t.
+        for (uint64_t a = 2; a < 10; ++a) {
+            BigInt base(a);
+            BigInt z = BigInt::modular_pow(base, two_t, p);
+            if (BigInt::modular_pow(z, q, p) != one) {
+                break; // a is a Fermat witness: p is composite
+            }
+            if (BigInt::gcd(z - one, p) == one) {
+                PocklingtonStep step = {p, q, base};
+                certificate.steps.push_back(step);
+                return certificate;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Re-checks every link of a certificate. Costs two modular exponentiations and one
+ *        gcd per step, independent of how many candidates generation had to try.
+ */
+bool verify_prime_certificate(const PrimeCertificate& certificate) {
+    if (certificate.base_prime.bit_length() > BASE_PRIME_BITS) return false;
+    uint64_t base = certificate.base_prime.is_zero() ? 0 : certificate.base_prime.limb_data()[0];
+    if (!is_prime_trial_division(base)) return false;
+
+    BigInt previous = certificate.base_prime;
+    for (const PocklingtonStep& step : certificate.steps) {
+        if (step.q != previous || !verify_step(step)) return false;
+        previous = step.p;
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef SHAWE_TAYLOR_H
+#define SHAWE_TAYLOR_H
+
+#include "bigint.h"
+#include "cmwc.h"
+#include <vector>
+
+/**
+ * @brief One link of a Pocklington certificate: p = 2tq + 1 is prime because q is a proven
+ *        prime with q > sqrt(p), a^(p-1) = 1 (mod p) and gcd(a^((p-1)/q) - 1, p) = 1.
+ */
+struct PocklingtonStep {
+    BigInt p;
+    BigInt q;
+    BigInt a;
+};
+
+/**
+ * @brief Primality certificate: a small prime checked by trial division, followed by
+ *        Pocklington steps that each build on the previous prime. The last p is the prime.
+ */
+struct PrimeCertificate {
+    BigInt base_prime;
+    std::vector<PocklingtonStep> steps;
+
+    PrimeCertificate() : base_prime(uint64_t(0)) {}
+    const BigInt& prime() const { return steps.empty() ? base_prime : steps.back().p; }
+};
+
+PrimeCertificate generate_provable_prime(int bits, CMWC& rng);
+bool verify_prime_certificate(const PrimeCertificate& certificate);
+
+#endif // SHAWE_TAYLOR_H
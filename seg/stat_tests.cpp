@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "stat_tests.h"
+
+namespace {
+
+const size_t BLOCK_BITS = 128;            // block frequency block size M
+const unsigned int BIRTHDAY_DAY_BITS = 24; // "year" of 2^24 days
+const double BIRTHDAY_LAMBDA = 2.0;       // m^3 / (4n) = 512^3 / 2^26
+
+/**
+ * @brief Counts ones and transition/11 pairs inside the low `n` bits of a word (1 <= n <= 64).
+ */
+inline void count_word(uint64_t w, unsigned int n, uint64_t& ones, uint64_t& transitions, uint64_t& pairs11) {
+    uint64_t mask = n == 64 ? ~uint64_t(0) : ((uint64_t(1) << n) - 1);
+    uint64_t pair_mask = mask >> 1; // pairs (i, i+1) with i + 1 < n
+    w &= mask;
+    ones += __builtin_popcountll(w);
+    transitions += __builtin_popcountll((w ^ (w >> 1)) & pair_mask);
+    pairs11 += __builtin_popcountll(w & (w >> 1) & pair_mask);
+}
+
+/**
+ * @brief Counts 111 and 101 triples starting at the low `starts` positions of `w`; bits past
+ *        the top of `w` are taken from `next`.
+ */
+inline void count_triples(uint64_t w, uint64_t next, unsigned int starts, uint64_t& t111, uint64_t& t101) {
+    if (starts == 0) return;
+    uint64_t mask = starts >= 64 ? ~uint64_t(0) : ((uint64_t(1) << starts) - 1);
+    uint64_t b = (w >> 1) | (next << 63);
+    uint64_t c = (w >> 2) | (next << 62);
+    t111 += __builtin_popcountll(w & b & c & mask);
+    t101 += __builtin_popcountll(w & ~b & c & mask);
+}
+
+/**
+ * @brief Counts the 111 and 101 triples that straddle a join: `left` holds the last
+ *        `left_bits` (at most 2) bits before it, oldest first, and `right` the first
+ *        `right_bits` (at most 2) bits after it.
+ */
+void count_join_triples(const int* left, unsigned int left_bits, const int* right, unsigned int right_bits,
+                        uint64_t& t111, uint64_t& t101) {
+    int seq[4];
+    unsigned int len = 0;
+    for (unsigned int i = 0; i < left_bits; ++i) seq[len++] = left[i];
+    for (unsigned int i = 0; i < right_bits; ++i) seq[len++] = right[i];
+    for (unsigned int start = left_bits >= 2 ? left_bits - 2 : 0; start < left_bits && start + 2 < len; ++start) {
+        t111 += seq[start] & seq[start + 1] & seq[start + 2];
+        t101 += seq[start] & !seq[start + 1] & seq[start + 2];
+    }
+}
+
+/**
+ * @brief Iteration cap for the incomplete gamma expansions. Near x = a both need on the order
+ *        of sqrt(a) terms, and the block frequency test calls them with a in the millions.
+ */
+int gamma_iterations(double a) {
+    return 1000 + static_cast<int>(20.0 * std::sqrt(a));
+}
+
+/**
+ * @brief Regularized lower incomplete gamma P(a, x) by its series (x < a + 1).
+ */
+double gamma_series(double a, double x) {
+    double sum = 1.0 / a;
+    double term = sum;
+    const int iterations = gamma_iterations(a);
+    for (int n = 1; n < iterations; ++n) {
+        term *= x / (a + n);
+        sum += term;
+        if (std::fabs(term) < std::fabs(sum) * 1e-15) break;
+    }
+    return sum * std::exp(-x + a * std::log(x) - std::lgamma(a));
+}
+
+/**
+ * @brief Regularized upper incomplete gamma Q(a, x) by Lentz's continued fraction (x >= a + 1).
+ */
+double gamma_continued_fraction(double a, double x) {
+    const double tiny = 1e-300;
+    double b = x + 1.0 - a;
+    double c = 1.0 / tiny;
+    double d = 1.0 / b;
+    double h = d;
+    const int iterations = gamma_iterations(a);
+    for (int i = 1; i < iterations; ++i) {
+        double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = b + an / c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1.0) < 1e-15) break;
+    }
+    return std::exp(-x + a * std::log(x) - std::lgamma(a)) * h;
+}
+
+/**
+ * @brief Regularized upper incomplete gamma function Q(a, x), NIST SP 800-22's igamc.
+ */
+double igamc(double a, double x) {
+    if (x <= 0.0) return 1.0;
+    if (x < a + 1.0) return 1.0 - gamma_series(a, x);
+    return gamma_continued_fraction(a, x);
+}
+
+double poisson_probability(double lambda, unsigned int k) {
+    return std::exp(-lambda + k * std::log(lambda) - std::lgamma(k + 1.0));
+}
+
+} // namespace
+
+BitStats::BitStats()
+    : bits(0), ones(0), transitions(0), pairs11(0), triples111(0), triples101(0),
+      first_bit(0), second_bit(0), penultimate_bit(0), last_bit(0),
+      block_deviation(0.0), blocks(0), birthday_samples(0) {
+    std::memset(byte_counts, 0, sizeof(byte_counts));
+    std::memset(birthday_histogram, 0, sizeof(birthday_histogram));
+}
+
+/**
+ * @brief Appends `nbits` bits, least significant first, from `words`.
+ *
+ * All counting is done a word at a time with popcount; only full bytes enter the byte
+ * histogram and only full 128-bit blocks enter the block frequency sum, so callers should
+ * feed chunks whose size is a multiple of 128 bits except for the very last one.
+ */
+void BitStats::add(const uint64_t* words, size_t nbits) {
+    if (nbits == 0) return;
+
+    size_t full_words = nbits / 64;
+    unsigned int tail = nbits % 64;
+
+    int first = words[0] & 1;
+    int second = nbits > 1 ? (words[0] >> 1) & 1 : 0;
+    if (bits > 0) {
+        transitions += last_bit != first;
+        pairs11 += last_bit & first;
+        int left[2] = {penultimate_bit, last_bit};
+        int right[2] = {first, second};
+        unsigned int left_bits = bits > 1 ? 2 : 1;
+        count_join_triples(left + 2 - left_bits, left_bits, right, nbits > 1 ? 2 : 1, triples111, triples101);
+    }
+    if (bits == 0) {
+        first_bit = first;
+        second_bit = second;
+    } else if (bits == 1) {
+        second_bit = first;
+    }
+
+    uint64_t o = 0, t = 0, p = 0, t111 = 0, t101 = 0;
+    for (size_t i = 0; i < full_words; ++i) {
+        uint64_t w = words[i];
+        size_t remaining = nbits - 64 * i;
+        uint64_t following = i + 1 < full_words || tail > 0 ? words[i + 1] : 0;
+        count_triples(w, following, remaining >= 66 ? 64 : (remaining > 2 ? remaining - 2 : 0), t111, t101);
+        o += __builtin_popcountll(w);
+        t += __builtin_popcountll((w ^ (w >> 1)) & 0x7FFFFFFFFFFFFFFFULL);
+        p += __builtin_popcountll(w & (w >> 1));
+        if (i + 1 < full_words || tail > 0) {
+            // Pair formed by this word's top bit and the next word's bottom bit.
+            uint64_t top = w >> 63;
+            uint64_t next = words[i + 1] & 1;
+            t += top ^ next;
+            p += top & next;
+        }
+        for (int b = 0; b < 8; ++b) {
+            ++byte_counts[(w >> (8 * b)) & 0xFF];
+        }
+    }
+    if (tail > 0) {
+        uint64_t w = words[full_words];
+        count_word(w, tail, o, t, p);
+        count_triples(w, 0, tail > 2 ? tail - 2 : 0, t111, t101);
+        for (unsigned int b = 0; b < tail / 8; ++b) {
+            ++byte_counts[(w >> (8 * b)) & 0xFF];
+        }
+    }
+    ones += o;
+    transitions += t;
+    pairs11 += p;
+    triples111 += t111;
+    triples101 += t101;
+
+    for (size_t i = 0; i + 2 <= full_words; i += 2) {
+        int block_ones = __builtin_popcountll(words[i]) + __builtin_popcountll(words[i + 1]);
+        double deviation = double(block_ones) / BLOCK_BITS - 0.5;
+        block_deviation += deviation * deviation;
+        ++blocks;
+    }
+
+    uint64_t last_word = tail > 0 ? words[full_words] : words[full_words - 1];
+    unsigned int last_index = tail > 0 ? tail - 1 : 63;
+    if (nbits > 1) {
+        size_t index = nbits - 2;
+        penultimate_bit = (words[index / 64] >> (index % 64)) & 1;
+    } else {
+        penultimate_bit = last_bit;
+    }
+    last_bit = (last_word >> last_index) & 1;
+    bits += nbits;
+}
+
+/**
+ * @brief Marsaglia's birthday spacings on BIRTHDAY_WORDS birthdays taken from the top
+ *        24 bits of consecutive words; records how many spacings repeat.
+ */
+void BitStats::add_birthday_sample(const uint64_t* words) {
+    uint32_t days[BIRTHDAY_WORDS];
+    for (size_t i = 0; i < BIRTHDAY_WORDS; ++i) {
+        days[i] = uint32_t(words[i] >> (64 - BIRTHDAY_DAY_BITS));
+    }
+    std::sort(days, days + BIRTHDAY_WORDS);
+    uint32_t spacings[BIRTHDAY_WORDS];
+    spacings[0] = days[0];
+    for (size_t i = 1; i < BIRTHDAY_WORDS; ++i) {
+        spacings[i] = days[i] - days[i - 1];
+    }
+    std::sort(spacings, spacings + BIRTHDAY_WORDS);
+    unsigned int duplicates = 0;
+    for (size_t i = 1; i < BIRTHDAY_WORDS; ++i) {
+        duplicates += spacings[i] == spacings[i - 1];
+    }
+    ++birthday_histogram[std::min(duplicates, 7u)];
+    ++birthday_samples;
+}
+
+/**
+ * @brief Folds in the statistics of the piece of stream that directly follows this one.
+ */
+void BitStats::merge(const BitStats& next) {
+    if (next.bits == 0) return;
+    if (bits == 0) {
+        *this = next;
+        return;
+    }
+    transitions += next.transitions + (last_bit != next.first_bit);
+    pairs11 += next.pairs11 + (last_bit & next.first_bit);
+    int left[2] = {penultimate_bit, last_bit};
+    int right[2] = {next.first_bit, next.second_bit};
+    unsigned int left_bits = bits > 1 ? 2 : 1;
+    count_join_triples(left + 2 - left_bits, left_bits, right, next.bits > 1 ? 2 : 1, triples111, triples101);
+    triples111 += next.triples111;
+    triples101 += next.triples101;
+    if (bits == 1) second_bit = next.first_bit;
+    penultimate_bit = next.bits > 1 ? next.penultimate_bit : last_bit;
+    bits += next.bits;
+    ones += next.ones;
+    last_bit = next.last_bit;
+    for (int i = 0; i < 256; ++i) {
+        byte_counts[i] += next.byte_counts[i];
+    }
+    block_deviation += next.block_deviation;
+    blocks += next.blocks;
+    birthday_samples += next.birthday_samples;
+    for (int i = 0; i < 8; ++i) {
+        birthday_histogram[i] += next.birthday_histogram[i];
+    }
+}
+
+double chi_square_p_value(double chi2, double degrees_of_freedom) {
+    return igamc(degrees_of_freedom / 2.0, chi2 / 2.0);
+}
+
+/**
+ * @brief Turns accumulated counters into test statistics and p-values.
+ *
+ * Monobit, runs, block frequency and serial (m = 3) follow NIST SP 800-22; poker is the
+ * FIPS 140 4-bit test; the byte test is a 255-degree chi-square; birthday spacings compares
+ * the duplicate counts with Poisson(2) as in Marsaglia's Diehard. Tests that do not have
+ * enough data report a p-value of -1.
+ */
+std::vector<TestResult> evaluate(const BitStats& s) {
+    std::vector<TestResult> results;
+    double n = double(s.bits);
+
+    // Monobit
+    double s_obs = std::fabs(2.0 * s.ones - n) / std::sqrt(n);
+    results.push_back(TestResult{"monobit", s_obs, std::erfc(s_obs / std::sqrt(2.0))});
+
+    // Runs
+    double pi = s.ones / n;
+    double v_obs = double(s.transitions) + 1.0;
+    if (std::fabs(pi - 0.5) >= 2.0 / std::sqrt(n)) {
+        results.push_back(TestResult{"runs", v_obs, 0.0});
+    } else {
+        double expected = 2.0 * n * pi * (1.0 - pi);
+        double p = std::erfc(std::fabs(v_obs - expected) / (2.0 * std::sqrt(2.0 * n) * pi * (1.0 - pi)));
+        results.push_back(TestResult{"runs", v_obs, p});
+    }
+
+    // Block frequency
+    if (s.blocks > 0) {
+        double chi2 = 4.0 * BLOCK_BITS * s.block_deviation;
+        results.push_back(TestResult{"block_frequency", chi2, igamc(s.blocks / 2.0, chi2 / 2.0)});
+    } else {
+        results.push_back(TestResult{"block_frequency", 0.0, -1.0});
+    }
+
+    // Serial, m = 3, on the circular sequence. With m = 2 the second difference depends only
+    // on the transition count and repeats the runs test. On a circle the 2-bit counts follow
+    // from ones, transitions and 11 pairs, and the 3-bit counts from those plus 111 and 101.
+    double wrap_transition = s.last_bit != s.first_bit;
+    double wrap_11 = s.last_bit & s.first_bit;
+    uint64_t wrap_111 = 0, wrap_101 = 0;
+    if (s.bits >= 2) {
+        int tail[2] = {s.penultimate_bit, s.last_bit};
+        int head[2] = {s.first_bit, s.second_bit};
+        count_join_triples(tail, 2, head, 2, wrap_111, wrap_101);
+    }
+    double v11 = s.pairs11 + wrap_11;
+    double v10 = (s.transitions + wrap_transition) / 2.0;
+    double v01 = v10;
+    double v00 = n - v11 - v10 - v01;
+    double v111 = double(s.triples111 + wrap_111);
+    double v101 = double(s.triples101 + wrap_101);
+    double v110 = v11 - v111, v011 = v11 - v111;
+    double v100 = v10 - v101, v001 = v01 - v101;
+    double v010 = v01 - v011, v000 = v00 - v001;
+    double psi3 = 8.0 / n * (v000 * v000 + v001 * v001 + v010 * v010 + v011 * v011 +
+                             v100 * v100 + v101 * v101 + v110 * v110 + v111 * v111) - n;
+    double psi2 = 4.0 / n * (v00 * v00 + v01 * v01 + v10 * v10 + v11 * v11) - n;
+    double zeros = n - s.ones;
+    double psi1 = 2.0 / n * (zeros * zeros + double(s.ones) * s.ones) - n;
+    double del1 = psi3 - psi2;
+    double del2 = psi3 - 2.0 * psi2 + psi1;
+    results.push_back(TestResult{"serial_1", del1, igamc(2.0, del1 / 2.0)});
+    results.push_back(TestResult{"serial_2", del2, igamc(1.0, del2 / 2.0)});
+
+    // Poker on 4-bit nibbles, derived from the byte histogram.
+    uint64_t nibbles[16] = {0};
+    uint64_t total_bytes = 0;
+    for (int b = 0; b < 256; ++b) {
+        nibbles[b & 0xF] += s.byte_counts[b];
+        nibbles[b >> 4] += s.byte_counts[b];
+        total_bytes += s.byte_counts[b];
+    }
+    if (total_bytes > 0) {
+        double k = 2.0 * total_bytes;
+        double sum = 0.0;
+        for (int i = 0; i < 16; ++i) {
+            sum += double(nibbles[i]) * nibbles[i];
+        }
+        double chi2 = 16.0 / k * sum - k;
+        results.push_back(TestResult{"poker", chi2, chi_square_p_value(chi2, 15)});
+
+        double expected = total_bytes / 256.0;
+        double byte_chi2 = 0.0;
+        for (int b = 0; b < 256; ++b) {
+            double d = s.byte_counts[b] - expected;
+            byte_chi2 += d * d / expected;
+        }
+        results.push_back(TestResult{"byte_chi_square", byte_chi2, chi_square_p_value(byte_chi2, 255)});
+    } else {
+        results.push_back(TestResult{"poker", 0.0, -1.0});
+        results.push_back(TestResult{"byte_chi_square", 0.0, -1.0});
+    }
+
+    // Birthday spacings
+    if (s.birthday_samples > 0) {
+        double chi2 = 0.0;
+        double tail = 1.0;
+        for (unsigned int k = 0; k < 8; ++k) {
+            double prob = k < 7 ? poisson_probability(BIRTHDAY_LAMBDA, k) : tail;
+            tail -= prob;
+            double expected = prob * s.birthday_samples;
+            double d = s.birthday_histogram[k] - expected;
+            chi2 += d * d / expected;
+        }
+        results.push_back(TestResult{"birthday_spacings", chi2, chi_square_p_value(chi2, 7)});
+    } else {
+        results.push_back(TestResult{"birthday_spacings", 0.0, -1.0});
+    }
+
+    return results;
+}
@@ -0,0 +1,55 @@
+#ifndef STAT_TESTS_H
+#define STAT_TESTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Mergeable counters for a battery of statistical tests over a bit stream.
+ *
+ * Bits are taken least significant first from each 64-bit word. Two BitStats built over
+ * consecutive pieces of a stream can be merged into the statistics of the concatenation,
+ * which is what lets the battery split a long stream across threads.
+ */
+struct BitStats {
+    uint64_t bits;        // total bits seen
+    uint64_t ones;        // monobit
+    uint64_t transitions; // adjacent positions with different bits (runs test)
+    uint64_t pairs11;     // adjacent positions both set (serial test)
+    uint64_t triples111;  // overlapping 3-bit patterns 111 and 101 (serial test, m = 3)
+    uint64_t triples101;
+    int first_bit;
+    int second_bit;
+    int penultimate_bit;
+    int last_bit;
+
+    uint64_t byte_counts[256]; // chi-square on bytes; poker test uses its nibbles
+
+    double block_deviation; // sum over 128-bit blocks of (ones/128 - 1/2)^2
+    uint64_t blocks;
+
+    uint64_t birthday_samples;
+    uint64_t birthday_histogram[8]; // duplicate-spacing counts 0..6, 7 = 7 or more
+
+    BitStats();
+
+    void add(const uint64_t* words, size_t nbits);
+    void add_birthday_sample(const uint64_t* words);
+    void merge(const BitStats& next);
+};
+
+struct TestResult {
+    std::string name;
+    double statistic;
+    double p_value;
+};
+
+std::vector<TestResult> evaluate(const BitStats& stats);
+
+double chi_square_p_value(double chi2, double degrees_of_freedom);
+
+const size_t BIRTHDAY_WORDS = 512; // birthdays per sample, each taken from one word
+
+#endif // STAT_TESTS_H
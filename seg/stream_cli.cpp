@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "bigint_io.h"
+#include "stream_cli.h"
+
+namespace {
+
+std::atomic<bool> stop_requested(false);
+
+void request_stop(int) {
+    stop_requested.store(true);
+}
+
+const uint64_t MAX_THREADS = 1024;
+
+/**
+ * @brief Parses a whole decimal argument into `value`, requiring min <= value <= max.
+ * @return false for empty input, trailing characters, signs, or values out of range.
+ */
+bool parse_unsigned(const char* text, uint64_t min, uint64_t max, uint64_t& value) {
+    if (*text < '0' || *text > '9') return false;
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || *end != '\0' || parsed < min || parsed > max) return false;
+    value = parsed;
+    return true;
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " <bits> [count] [options]" << std::endl;
+    std::cerr << "  Without a count or --forever, times 1000 generations and prints the average." << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --forever              generate until interrupted (Ctrl-C)" << std::endl;
+    std::cerr << "  --format hex|bigs|raw  hex lines, BigInt stream, or raw little-endian limbs (default hex)" << std::endl;
+    std::cerr << "  --output FILE          write to FILE instead of stdout" << std::endl;
+    std::cerr << "  --threads N            generate on N threads (default 1)" << std::endl;
+    std::cerr << "  --buffer BYTES         size of each batched write (default 1048576)" << std::endl;
+    std::cerr << "  --seed N               seed for the first thread (default: current time)" << std::endl;
+    std::cerr << "Available bit sizes: 40, 56, 80, 128, 168, 224, 256, 512, 1024, 2048, 4096" << std::endl;
+}
+
+/**
+ * @brief Largest number of bytes one number can take in the chosen format.
+ */
+size_t max_encoded_size(StreamFormat format, int bits) {
+    size_t limbs = (bits + 63) / 64;
+    switch (format) {
+        case FORMAT_HEX: return 2 + limbs * 16 + 1;
+        case FORMAT_BIGS: return (limbs + 1) * sizeof(uint64_t);
+        case FORMAT_RAW: return limbs * sizeof(uint64_t);
+    }
+    return 0;
+}
+
+/**
+ * @brief Loads the low `bits` bits of `value` into `out`, using `window` as limb scratch space.
+ *
+ * Generators fill whole 64-bit limbs (xorshift returns 63-bit words at every size), so the
+ * top limb is masked here, as StreamPacker does in randomness.cpp, to keep every format
+ * within the requested width.
+ */
+void truncate_to_bits(const BigInt& value, int bits, std::vector<uint64_t>& window, BigInt& out) {
+    size_t available = value.limb_count();
+    for (size_t i = 0; i < window.size(); ++i) {
+        window[i] = i < available ? value.limb_data()[i] : 0;
+    }
+    if (bits % 64 != 0) {
+        window.back() &= (uint64_t(1) << (bits % 64)) - 1;
+    }
+    out.assign_limbs(window.data(), window.size());
+}
+
+size_t encode(StreamFormat format, int bits, const BigInt& value, char* out) {
+    switch (format) {
+        case FORMAT_HEX: {
+            out[0] = '0';
+            out[1] = 'x';
+            size_t n = value.write_hex(out + 2, (bits + 63) / 64 * 16);
+            out[2 + n] = '\n';
+            return n + 3;
+        }
+        case FORMAT_BIGS:
+            return BigIntWriter::encode_record(value, out);
+        case FORMAT_RAW: {
+            size_t size = (bits + 63) / 64 * sizeof(uint64_t);
+            size_t used = std::min(value.limb_count() * sizeof(uint64_t), size);
+            std::memcpy(out, value.limb_data(), used);
+            std::memset(out + used, 0, size - used);
+            return size;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+/**
+ * @brief Generates numbers on `options.threads` threads and writes them to `out` in batches.
+ *
+ * Each thread owns a generator (thread i is seeded with seed ^ i * golden-ratio constant),
+ * encodes a batch of roughly `buffer_bytes` into a private buffer, and then appends the whole
+ * batch to the output under a lock, so the output sees few, large writes. The run ends after
+ * `count` numbers, on SIGINT/SIGTERM, or when the output fails.
+ *
+ * @return Totals, elapsed wall time and the write error, if any, for the throughput report.
+ */
+StreamReport run_stream(const StreamOptions& options, const GeneratorMaker& make_generator,
+                        uint16_t generator_id, std::ostream& out) {
+    const size_t record_max = max_encoded_size(options.format, options.bits);
+    const uint64_t batch_numbers = std::max<uint64_t>(1, options.buffer_bytes / record_max);
+    const unsigned int threads = std::max(1u, options.threads);
+
+    std::vector<RandomPool::Generator> generators;
+    for (unsigned int i = 0; i < threads; ++i) {
+        generators.push_back(make_generator(options.bits, options.seed ^ (0x9E3779B97F4A7C15ULL * i)));
+    }
+
+    std::unique_ptr<BigIntWriter> writer;
+    if (options.format == FORMAT_BIGS) {
+        // The count stays unknown until finish() patches it, so an interrupted run or a pipe
+        // never leaves a header promising records that are not there.
+        BigIntStreamHeader header(options.bits, generator_id, options.seed);
+        writer.reset(new BigIntWriter(out, header, options.buffer_bytes));
+    }
+
+    std::mutex output_mutex;
+    std::atomic<uint64_t> claimed(0);
+    std::atomic<bool> failed(false);
+    std::string error;
+    StreamReport report = {0, 0, 0.0, std::string()};
+
+    auto worker = [&](unsigned int index) {
+        std::vector<char> buffer(batch_numbers * record_max);
+        std::vector<uint64_t> window((options.bits + 63) / 64);
+        BigInt value(uint64_t(0));
+        RandomPool::Generator& generate = generators[index];
+        while (!stop_requested.load(std::memory_order_relaxed) && !failed.load(std::memory_order_relaxed)) {
+            uint64_t n = batch_numbers;
+            if (!options.forever) {
+                uint64_t first = claimed.fetch_add(batch_numbers);
+                if (first >= options.count) break;
+                n = std::min(batch_numbers, options.count - first);
+            }
+
+            size_t length = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                truncate_to_bits(generate(), options.bits, window, value);
+                length += encode(options.format, options.bits, value, &buffer[length]);
+            }
+
+            std::lock_guard<std::mutex> lock(output_mutex);
+            if (failed.load()) break;
+            try {
+                if (writer) {
+                    writer->write_encoded(buffer.data(), length, n);
+                } else {
+                    out.write(buffer.data(), length);
+                    if (!out) throw std::runtime_error("Write failed.");
+                }
+            } catch (const std::exception& e) {
+                error = e.what();
+                failed.store(true);
+                break;
+            }
+            report.numbers += n;
+            report.bytes += length;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned int i = 0; i < threads; ++i) {
+        pool.push_back(std::thread(worker, i));
+    }
+    for (auto& t : pool) {
+        t.join();
+    }
+    if (writer && !failed.load()) {
+        writer->finish();
+    } else if (!failed.load()) {
+        out.flush();
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.error = error;
+    return report;
+}
+
+/**
+ * @brief Shared main() for the generator tools: parses options and either streams numbers
+ *        or falls back to the tool's original timing mode.
+ */
+int run_stream_cli(int argc, char* argv[], const GeneratorMaker& make_generator, uint16_t generator_id,
+                   const std::function<void(int bits)>& timing_mode) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    StreamOptions options;
+    uint64_t bits;
+    if (!parse_unsigned(argv[1], 1, 1 << 20, bits)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    options.bits = static_cast<int>(bits);
+    options.count = 0;
+    options.forever = false;
+    options.format = FORMAT_HEX;
+    options.threads = 1;
+    options.buffer_bytes = 1 << 20;
+    options.seed = time(0);
+
+    bool count_given = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        uint64_t number = 0;
+        bool valid = true;
+        if (arg == "--forever") {
+            options.forever = true;
+        } else if (arg == "--format" && has_value) {
+            std::string format = argv[++i];
+            if (format == "hex") options.format = FORMAT_HEX;
+            else if (format == "bigs") options.format = FORMAT_BIGS;
+            else if (format == "raw") options.format = FORMAT_RAW;
+            else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--output" && has_value) {
+            options.output = argv[++i];
+        } else if (arg == "--threads" && has_value) {
+            valid = parse_unsigned(argv[++i], 1, MAX_THREADS, number);
+            options.threads = static_cast<unsigned int>(number);
+        } else if (arg == "--buffer" && has_value) {
+            valid = parse_unsigned(argv[++i], 1, uint64_t(1) << 30, number);
+            options.buffer_bytes = static_cast<size_t>(number);
+        } else if (arg == "--seed" && has_value) {
+            valid = parse_unsigned(argv[++i], 0, ~uint64_t(0), number);
+            options.seed = number;
+        } else if (arg[0] != '-' && !count_given) {
+            valid = parse_unsigned(arg.c_str(), 1, ~uint64_t(0), number);
+            options.count = number;
+            count_given = true;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    try {
+        if (options.count == 0 && !options.forever) {
+            timing_mode(options.bits);
+            return 0;
+        }
+
+        std::signal(SIGINT, request_stop);
+        std::signal(SIGTERM, request_stop);
+#ifdef SIGPIPE
+        std::signal(SIGPIPE, SIG_IGN);
+#endif
+        std::ios::sync_with_stdio(false);
+
+        StreamReport report;
+        if (options.output.empty()) {
+            report = run_stream(options, make_generator, generator_id, std::cout);
+        } else {
+            std::ofstream file(options.output.c_str(), std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Cannot open " + options.output);
+            }
+            report = run_stream(options, make_generator, generator_id, file);
+        }
+
+        double seconds = std::max(report.seconds, 1e-9);
+        std::cerr << std::fixed << std::setprecision(3)
+                  << "Generated " << report.numbers << " " << options.bits << "-bit numbers ("
+                  << report.bytes / 1e6 << " MB) in " << report.seconds << " s: "
+                  << std::setprecision(0) << report.numbers / seconds << " numbers/s, "
+                  << std::setprecision(1) << report.bytes / 1e6 / seconds << " MB/s" << std::endl;
+        if (!report.error.empty()) {
+            // Also reached when the reader of a pipe goes away (e.g. `| head`).
+            std::cerr << "Output stopped: " << report.error << std::endl;
+            return 1;
+        }
+        if (!options.forever && report.numbers < options.count) {
+            std::cerr << "Interrupted after " << report.numbers << " of " << options.count
+                      << " numbers." << std::endl;
+            return 1;
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << "Available bit sizes: 40, 56, 80, 128, 168, 224, 256, 512, 1024, 2048, 4096" << std::endl;
+        return 1;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
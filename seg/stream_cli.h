@@ -0,0 +1,40 @@
+#ifndef STREAM_CLI_H
+#define STREAM_CLI_H
+
+#include "random_pool.h"
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+
+enum StreamFormat {
+    FORMAT_HEX,  // one "0x..." line per number
+    FORMAT_BIGS, // BigInt stream format from bigint_io.h
+    FORMAT_RAW   // fixed-size little-endian limbs, no framing
+};
+
+struct StreamOptions {
+    int bits;
+    uint64_t count;      // numbers to generate; ignored when forever is set
+    bool forever;        // run until interrupted
+    StreamFormat format;
+    std::string output;  // empty for stdout
+    unsigned int threads;
+    size_t buffer_bytes; // target size of each batched write
+    uint64_t seed;
+};
+
+struct StreamReport {
+    uint64_t numbers;
+    uint64_t bytes;
+    double seconds;
+    std::string error; // empty unless writing failed
+};
+
+StreamReport run_stream(const StreamOptions& options, const GeneratorMaker& make_generator,
+                        uint16_t generator_id, std::ostream& out);
+
+int run_stream_cli(int argc, char* argv[], const GeneratorMaker& make_generator, uint16_t generator_id,
+                   const std::function<void(int bits)>& timing_mode);
+
+#endif // STREAM_CLI_H
@@ -2,8 +2,13 @@
 #define XORSHIFT_H
 
 #include "bigint.h"
+#include <vector>
 #include <chrono>
 
+void xorshift(BigInt& state, int a, int b, int c);
+const std::vector<int>& xorshift_params(int bits);
+void xorshift_next(BigInt& state, int bits);
+
 BigInt generate_random(int bits, std::chrono::duration<double, std::milli>& duration);
 
 #endif // XORSHIFT_H
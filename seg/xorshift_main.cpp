@@ -0,0 +1,26 @@
+#include <iostream>
+#include <chrono>
+#include "bigint.h"
+#include "bigint_io.h"
+#include "random_pool.h"
+#include "stream_cli.h"
+#include "xorshift.h"
+
+/**
+ * @brief Original measurement: average time of 1000 calls to generate_random.
+ */
+void time_xorshift(int bits) {
+    double total_duration = 0;
+    for (int i = 0; i < 1000; i++) {
+        std::chrono::duration<double, std::milli> duration;
+        generate_random(bits, duration);
+        total_duration += duration.count();
+    }
+    total_duration = total_duration / 1000;
+
+    std::cout << "Total duration: " << total_duration << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    return run_stream_cli(argc, argv, make_xorshift_generator, GENERATOR_XORSHIFT, time_xorshift);
+}